@@ -20,10 +20,12 @@ SUBDIRS = \
     app \
     lib \
     tests \
+    tune \
 #    calc \
 #    calc2
 
 app.depends = lib
 tests.depends = lib
+tune.depends = lib
 #calc.depends = lib
 #calc2.depends = lib
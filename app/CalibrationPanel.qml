@@ -25,6 +25,7 @@ Item {
     CalibrationController {
         id: controller
         aruco: globalAruco
+        objectTracker: globalObjectTracker
     }
 
     ColumnLayout {
@@ -76,6 +77,39 @@ Item {
             }
         }
 
+        Row {
+            spacing: Style.smallMargin
+            MyLabel {
+                text: "DetectorParams.json"
+                verticalAlignment: Qt.AlignVCenter
+                height: parent.height
+            }
+            MyButton {
+                text: "Load"
+                onClicked: controller.loadDetectorParams()
+            }
+        }
+
+        Row {
+            spacing: Style.smallMargin
+            MyLabel {
+                text: "Boards.json"
+                verticalAlignment: Qt.AlignVCenter
+                height: parent.height
+            }
+            MyButton {
+                text: "Load"
+                onClicked: controller.loadBoards()
+            }
+        }
+
+        MyCheckBox {
+            text: "Show undistorted"
+            enabled: controller.calibrationValues.length > 0
+            checked: controller.showUndistorted
+            onCheckedChanged: controller.showUndistorted = checked
+        }
+
         Rectangle {
             Layout.fillHeight: true
             Layout.preferredWidth: 600
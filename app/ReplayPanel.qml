@@ -77,5 +77,21 @@ Rectangle {
             onTextChanged: controller.replayFps = text
             enabled: !controller.isReplayStreaming
         }
+        MyLabel {
+            text: "Smoothed"
+        }
+        MyButton {
+            Layout.leftMargin: Style.mediumMargin
+            id: saveSmoothedButton
+            text: "Save csv"
+            backgroundColor: Style.darkGray
+            enabled: controller.canReplayStream && !controller.isSmoothing
+            onClicked: controller.saveSmoothedTrajectories(controller.loadPath + "/smoothed.csv")
+        }
+        Connections {
+            target: controller
+            onSmoothingProgress: saveSmoothedButton.text = Math.floor(100 * frames / frameCount) + " %"
+            onSmoothingFinished: saveSmoothedButton.text = ok ? "Save csv" : "Failed, retry"
+        }
     }
 }
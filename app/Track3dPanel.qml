@@ -50,7 +50,31 @@ Item {
             anchors.bottom: parent.bottom
             anchors.margins: Style.smallMargin
 
-            text: controller.fps.toFixed(2) + " fps"
+            text: controller.fps.toFixed(2) + " fps, quality level " + globalObjectTracker.qualityLevel
+        }
+
+        MyLabel {
+            id: statisticsLabel
+            anchors.right: parent.right
+            anchors.bottom: parent.bottom
+            anchors.margins: Style.smallMargin
+
+            function refresh() {
+                var statistics = globalAruco.detectionStatistics()
+                var stages = statistics.stages
+                var counters = statistics.counters
+                text = "detection " + stages.detection.mean.toFixed(1) + " ms (p95 " + stages.detection.p95.toFixed(1) + ")"
+                        + ", refinement " + stages.refinement.mean.toFixed(1) + " ms"
+                        + ", pose " + stages.pose.mean.toFixed(2) + " ms"
+                        + ", " + counters.identified.mean.toFixed(1) + "/" + counters.candidates.mean.toFixed(1) + " candidates identified"
+            }
+
+            Timer {
+                interval: 1000
+                running: true
+                repeat: true
+                onTriggered: statisticsLabel.refresh()
+            }
         }
     }
 
@@ -209,5 +233,17 @@ Item {
                 }
             }
         }
+
+        MyCheckBox {
+            text: "Skip static frames"
+            checked: globalObjectTracker.skipStaticFrames
+            onCheckedChanged: globalObjectTracker.skipStaticFrames = checked
+        }
+
+        MyCheckBox {
+            text: "Adaptive quality"
+            checked: globalObjectTracker.adaptiveQuality
+            onCheckedChanged: globalObjectTracker.adaptiveQuality = checked
+        }
     }
 }
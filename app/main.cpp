@@ -66,7 +66,8 @@ int main(int argc, char *argv[])
     RecordController recordController;
     QObject::connect(&cameraController, &CameraController::imageChanged, &recordController, &RecordController::setImage, Qt::QueuedConnection);
     ReplayController replayController;
-    QObject::connect(&replayController, &ReplayController::imageChanged, &tracker, &ObjectTracker::processFrame, Qt::QueuedConnection);
+    replayController.setAruco(&aruco);
+    QObject::connect(&replayController, &ReplayController::framePlayed, &tracker, &ObjectTracker::processFrame, Qt::QueuedConnection);
 
     QQmlApplicationEngine engine;
     engine.rootContext()->setContextProperty("globalAruco", &aruco);
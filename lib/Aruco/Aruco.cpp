@@ -15,26 +15,152 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "Aruco.h"
+#include "DetectionStats.h"
+#include "MarkerBoard.h"
+#include "MarkerDecoder.h"
+#include "PointUndistorter.h"
+#include "SquarePose.h"
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <algorithm>
 #include <opencv2/aruco.hpp>
 #include <opencv2/calib3d.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 
+namespace {
+// the decoder is specialised on the marker size of the dictionary
+const cv::aruco::PREDEFINED_DICTIONARY_NAME DICTIONARY = cv::aruco::DICT_4X4_50;
+constexpr int MARKER_SIZE = 4;
+const int CELL_SIZE = 6;
+
+const int FAST_REFINEMENT_WIN_SIZE = 3;
+const int FAST_REFINEMENT_ITERATIONS = 10;
+const int FULL_REFINEMENT_ITERATIONS = 30;
+const double REFINEMENT_ACCURACY = 0.1;
+
+cv::Ptr<cv::aruco::DetectorParameters> createParameters(const Aruco::DetectorParams& p)
+{
+    auto result = cv::aruco::DetectorParameters::create();
+    result->adaptiveThreshWinSizeMin = p.adaptiveThreshWinSizeMin;
+    result->adaptiveThreshWinSizeMax = p.adaptiveThreshWinSizeMax;
+    result->adaptiveThreshWinSizeStep = p.adaptiveThreshWinSizeStep;
+    result->adaptiveThreshConstant = p.adaptiveThreshConstant;
+    result->minMarkerPerimeterRate = p.minMarkerPerimeterRate;
+    result->maxMarkerPerimeterRate = p.maxMarkerPerimeterRate;
+    result->polygonalApproxAccuracyRate = p.polygonalApproxAccuracyRate;
+    result->cornerRefinementWinSize = p.cornerRefinementWinSize;
+    // corners are refined afterwards, only for the markers that are worth it
+    result->cornerRefinementMethod = cv::aruco::CORNER_REFINE_NONE;
+    return result;
+}
+
+// a tilted marker looks smaller than a frontal one, perspective makes the near edge look larger
+const double TILTED_PERIMETER_FACTOR = 0.5;
+const double PERSPECTIVE_PERIMETER_FACTOR = 1.5;
+
+template <typename T>
+void readIfPresent(const cv::FileNode& node, T& value)
+{
+    if (!node.empty()) {
+        node >> value;
+    }
+}
+}
+
+Aruco::Markers::Markers()
+    : count(0)
+{
+}
+
+Aruco::Markers::Markers(const Markers& other)
+    : count(0)
+{
+    *this = other;
+}
+
+Aruco::Markers& Aruco::Markers::operator=(const Markers& other)
+{
+    if (this != &other) {
+        count = other.count;
+        std::copy_n(other.corners, 4 * count, corners);
+        std::copy_n(other.ids, count, ids);
+        std::copy_n(other.rvecs, count, rvecs);
+        std::copy_n(other.tvecs, count, tvecs);
+    }
+    return *this;
+}
+
+Aruco::DetectorParams::DetectorParams(
+    int adaptiveThreshWinSizeMin,
+    int adaptiveThreshWinSizeMax,
+    int adaptiveThreshWinSizeStep,
+    double adaptiveThreshConstant,
+    double minMarkerPerimeterRate,
+    double maxMarkerPerimeterRate,
+    double polygonalApproxAccuracyRate,
+    int cornerRefinementWinSize)
+    : adaptiveThreshWinSizeMin(adaptiveThreshWinSizeMin)
+    , adaptiveThreshWinSizeMax(adaptiveThreshWinSizeMax)
+    , adaptiveThreshWinSizeStep(adaptiveThreshWinSizeStep)
+    , adaptiveThreshConstant(adaptiveThreshConstant)
+    , minMarkerPerimeterRate(minMarkerPerimeterRate)
+    , maxMarkerPerimeterRate(maxMarkerPerimeterRate)
+    , polygonalApproxAccuracyRate(polygonalApproxAccuracyRate)
+    , cornerRefinementWinSize(cornerRefinementWinSize)
+{
+}
+
 struct Aruco::Data {
+    Data()
+        : dictionary(cv::aruco::getPredefinedDictionary(DICTIONARY))
+        , decoder(dictionary)
+    {
+    }
+
+    QSharedPointer<const PointUndistorter> currentCamera()
+    {
+        QMutexLocker lock(&parametersMutex);
+        return camera;
+    }
+
+    // the detector decodes against the allowed codewords only, its ids index allowedIds
+    struct Subset {
+        cv::Ptr<cv::aruco::Dictionary> dictionary;
+        std::vector<int> ids;
+    };
+
     cv::Ptr<cv::aruco::Dictionary> dictionary;
+    MarkerDecoder<MARKER_SIZE> decoder;
+    QSharedPointer<const Subset> allowed;
+    // parameters can be replaced from the gui thread while the tracking thread is detecting
+    QMutex parametersMutex;
+    Aruco::DetectorParams params;
     cv::Ptr<cv::aruco::DetectorParameters> parameters;
+    cv::Ptr<cv::aruco::DetectorParameters> depthParameters;
     float markerLengthInMm;
-    cv::Mat cameraMatrix;
-    cv::Mat distCoeffs;
+    // replaced as a whole from the gui thread, every call works on the one it took at its start
+    QSharedPointer<const PointUndistorter> camera;
+    std::vector<std::vector<cv::Point2f>> detectedCorners;
+    std::vector<int> detectedIds;
+    std::vector<std::vector<cv::Point2f>> rejectedCorners;
+    DetectionStats stats;
+    std::vector<cv::Point3f> boardObjectPoints;
+    std::vector<cv::Point2f> boardImagePoints;
+    cv::Mat scaledImage;
+    cv::Mat grayImage;
+    cv::Mat markerImage;
+    cv::Mat markerGray;
+    cv::Mat markerBinary;
+    cv::Mat markerBits;
 };
 
 Aruco::Aruco(QObject* parent)
     : QObject(parent)
     , _d(new Data())
 {
-    _d->dictionary = getPredefinedDictionary(cv::aruco::DICT_4X4_50);
-    _d->parameters = cv::aruco::DetectorParameters::create();
-    _d->parameters->cornerRefinementMethod = cv::aruco::CORNER_REFINE_SUBPIX;
+    _d->parameters = createParameters(_d->params);
+    _d->depthParameters = createParameters(_d->params);
     _d->markerLengthInMm = 32.0f;
 }
 
@@ -42,46 +168,344 @@ Aruco::~Aruco()
 {
 }
 
-void Aruco::setCameraMatrix(cv::Mat cameraMatrix, cv::Mat distCoeffs)
+void Aruco::setCameraMatrix(cv::Mat cameraMatrix, cv::Mat distCoeffs, cv::Size imageSize)
+{
+    QSharedPointer<const PointUndistorter> camera;
+    if (!cameraMatrix.empty() && !distCoeffs.empty()) {
+        camera.reset(new PointUndistorter(cameraMatrix, distCoeffs, imageSize));
+    }
+
+    QMutexLocker lock(&_d->parametersMutex);
+    _d->camera = camera;
+}
+
+void Aruco::copySettings(const Aruco& other)
+{
+    DetectorParams params;
+    QSharedPointer<const Data::Subset> allowed;
+    QSharedPointer<const PointUndistorter> camera;
+    {
+        QMutexLocker lock(&other._d->parametersMutex);
+        params = other._d->params;
+        allowed = other._d->allowed;
+        camera = other._d->camera;
+    }
+    auto parameters = createParameters(params);
+
+    QMutexLocker lock(&_d->parametersMutex);
+    _d->params = params;
+    _d->parameters = parameters;
+    _d->allowed = allowed;
+    _d->camera = camera;
+    _d->markerLengthInMm = other._d->markerLengthInMm;
+}
+
+Aruco::DetectorParams Aruco::detectorParams() const
+{
+    QMutexLocker lock(&_d->parametersMutex);
+    return _d->params;
+}
+
+void Aruco::setDetectorParams(const Aruco::DetectorParams& p)
 {
-    _d->cameraMatrix = cameraMatrix;
-    _d->distCoeffs = distCoeffs;
+    auto parameters = createParameters(p);
+
+    QMutexLocker lock(&_d->parametersMutex);
+    _d->params = p;
+    _d->parameters = parameters;
 }
 
-Aruco::Markers Aruco::detectMarkers(QImage image) const
+bool Aruco::loadDetectorParams(QString filename)
+{
+    cv::FileStorage file(filename.toStdString(), cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    if (!file.isOpened())
+        return false;
+
+    DetectorParams p;
+    readIfPresent(file["adaptiveThreshWinSizeMin"], p.adaptiveThreshWinSizeMin);
+    readIfPresent(file["adaptiveThreshWinSizeMax"], p.adaptiveThreshWinSizeMax);
+    readIfPresent(file["adaptiveThreshWinSizeStep"], p.adaptiveThreshWinSizeStep);
+    readIfPresent(file["adaptiveThreshConstant"], p.adaptiveThreshConstant);
+    readIfPresent(file["minMarkerPerimeterRate"], p.minMarkerPerimeterRate);
+    readIfPresent(file["maxMarkerPerimeterRate"], p.maxMarkerPerimeterRate);
+    readIfPresent(file["polygonalApproxAccuracyRate"], p.polygonalApproxAccuracyRate);
+    readIfPresent(file["cornerRefinementWinSize"], p.cornerRefinementWinSize);
+    setDetectorParams(p);
+
+    std::vector<int> allowedIds;
+    readIfPresent(file["allowedIds"], allowedIds);
+    QList<int> ids;
+    for (int id : allowedIds) {
+        ids << id;
+    }
+    return setAllowedIds(ids);
+}
+
+void Aruco::saveDetectorParams(QString filename) const
+{
+    const DetectorParams p = detectorParams();
+    cv::FileStorage file(filename.toStdString(), cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
+    file << "adaptiveThreshWinSizeMin" << p.adaptiveThreshWinSizeMin;
+    file << "adaptiveThreshWinSizeMax" << p.adaptiveThreshWinSizeMax;
+    file << "adaptiveThreshWinSizeStep" << p.adaptiveThreshWinSizeStep;
+    file << "adaptiveThreshConstant" << p.adaptiveThreshConstant;
+    file << "minMarkerPerimeterRate" << p.minMarkerPerimeterRate;
+    file << "maxMarkerPerimeterRate" << p.maxMarkerPerimeterRate;
+    file << "polygonalApproxAccuracyRate" << p.polygonalApproxAccuracyRate;
+    file << "cornerRefinementWinSize" << p.cornerRefinementWinSize;
+
+    const QList<int> ids = allowedIds();
+    if (!ids.isEmpty()) {
+        file << "allowedIds" << ids.toVector().toStdVector();
+    }
+}
+
+QList<int> Aruco::allowedIds() const
+{
+    QMutexLocker lock(&_d->parametersMutex);
+    QList<int> result;
+    if (_d->allowed) {
+        for (int id : _d->allowed->ids) {
+            result << id;
+        }
+    }
+    return result;
+}
+
+bool Aruco::setAllowedIds(QList<int> ids)
+{
+    const int dictionarySize = _d->dictionary->bytesList.rows;
+    if (std::any_of(ids.cbegin(), ids.cend(), [dictionarySize](int id) { return id < 0 || id >= dictionarySize; }))
+        return false;
+
+    QSharedPointer<Data::Subset> allowed;
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    if (!ids.isEmpty()) {
+        allowed.reset(new Data::Subset());
+        allowed->ids.assign(ids.cbegin(), ids.cend());
+        cv::Mat bytesList(int(allowed->ids.size()), _d->dictionary->bytesList.cols, _d->dictionary->bytesList.type());
+        for (int i = 0; i < bytesList.rows; ++i) {
+            _d->dictionary->bytesList.row(allowed->ids[i]).copyTo(bytesList.row(i));
+        }
+        allowed->dictionary = cv::makePtr<cv::aruco::Dictionary>(bytesList, _d->dictionary->markerSize, _d->dictionary->maxCorrectionBits);
+    }
+
+    QMutexLocker lock(&_d->parametersMutex);
+    _d->allowed = allowed;
+    return true;
+}
+
+Aruco::Markers Aruco::detectMarkers(QImage image, double scale, double nearestDepth, double farthestDepth) const
 {
     Markers result;
-    if (!image.size().isEmpty() && !_d->cameraMatrix.empty() && !_d->distCoeffs.empty()) {
+    cv::Ptr<cv::aruco::DetectorParameters> parameters;
+    QSharedPointer<const Data::Subset> allowed;
+    QSharedPointer<const PointUndistorter> camera;
+    {
+        QMutexLocker lock(&_d->parametersMutex);
+        parameters = _d->parameters;
+        allowed = _d->allowed;
+        camera = _d->camera;
+    }
+    if (!image.size().isEmpty() && camera) {
+        const cv::Ptr<cv::aruco::Dictionary>& dictionary = allowed ? allowed->dictionary : _d->dictionary;
+
+        if (nearestDepth > 0 && farthestDepth >= nearestDepth) {
+            // perimeter rates are relative to the largest image dimension, so they do not depend on scale
+            const double fx = camera->cameraMatrix().at<double>(0, 0);
+            const double fy = camera->cameraMatrix().at<double>(1, 1);
+            const double perimeter = 4 * _d->markerLengthInMm / std::max(image.width(), image.height());
+            const double minRate = std::max(parameters->minMarkerPerimeterRate, TILTED_PERIMETER_FACTOR * perimeter * std::min(fx, fy) / farthestDepth);
+            const double maxRate = std::min(parameters->maxMarkerPerimeterRate, PERSPECTIVE_PERIMETER_FACTOR * perimeter * std::max(fx, fy) / nearestDepth);
+            if (minRate < maxRate) {
+                *_d->depthParameters = *parameters;
+                _d->depthParameters->minMarkerPerimeterRate = minRate;
+                _d->depthParameters->maxMarkerPerimeterRate = maxRate;
+                parameters = _d->depthParameters;
+            }
+        }
+
         cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
-        cv::aruco::detectMarkers(view, _d->dictionary, result.corners, result.ids, _d->parameters, cv::noArray(), _d->cameraMatrix, _d->distCoeffs);
-        cv::aruco::estimatePoseSingleMarkers(result.corners, _d->markerLengthInMm, _d->cameraMatrix, _d->distCoeffs, result.rvecs, result.tvecs);
+        if (scale < 1.0) {
+            StageTimer timer(_d->stats, DetectionStats::Resize);
+            cv::resize(view, _d->scaledImage, cv::Size(), scale, scale, cv::INTER_AREA);
+        }
+        {
+            // the rejected candidates only cost a copy and tell how much work identification had
+            StageTimer timer(_d->stats, DetectionStats::Detection);
+            const cv::Mat& detectView = scale < 1.0 ? _d->scaledImage : view;
+            cv::aruco::detectMarkers(detectView, dictionary, _d->detectedCorners, _d->detectedIds, parameters, _d->rejectedCorners);
+        }
+        _d->stats.addCount(DetectionStats::Candidates, int(_d->detectedIds.size() + _d->rejectedCorners.size()));
+        _d->stats.addCount(DetectionStats::Identified, int(_d->detectedIds.size()));
+
+        result.count = std::min(int(_d->detectedIds.size()), Markers::CAPACITY);
+        _d->stats.addCount(DetectionStats::Dropped, int(_d->detectedIds.size()) - result.count);
+        for (int i = 0; i < result.count; ++i) {
+            result.ids[i] = allowed ? allowed->ids[_d->detectedIds[i]] : _d->detectedIds[i];
+            std::copy(_d->detectedCorners[i].cbegin(), _d->detectedCorners[i].cbegin() + 4, result.corners + 4 * i);
+        }
+
+        if (scale < 1.0) {
+            // back to full resolution pixel centers, refinement wins back the precision lost by downscaling
+            const float inverseScale = float(1.0 / scale);
+            for (int i = 0; i < 4 * result.count; ++i) {
+                result.corners[i] = (result.corners[i] + cv::Point2f(0.5f, 0.5f)) * inverseScale - cv::Point2f(0.5f, 0.5f);
+            }
+        }
     }
     return result;
 }
 
-std::vector<float> Aruco::calc2dAngles(const Aruco::Markers& markers) const
+void Aruco::estimatePoses(Aruco::Markers& markers, const std::vector<MarkerBoard>* boards) const
 {
-    std::vector<cv::Point3f> axesPoints;
-    axesPoints.push_back(cv::Point3f(0, 0, 0));
-    axesPoints.push_back(cv::Point3f(1, 0, 0));
-    std::vector<float> results;
+    const int count = markers.count;
+    const QSharedPointer<const PointUndistorter> camera = _d->currentCamera();
+    if (count == 0 || !camera)
+        return;
 
-    for (uint i = 0; i < markers.rvecs.size(); ++i) {
-        std::vector<cv::Point2f> proj;
-        projectPoints(axesPoints, markers.rvecs.at(i), markers.tvecs.at(i), _d->cameraMatrix, _d->distCoeffs, proj);
-        results.push_back(atan2(proj.at(1).y - proj.at(0).y, proj.at(1).x - proj.at(0).x));
+    StageTimer timer(_d->stats, DetectionStats::Pose);
+    // only the corners are undistorted, then every marker is solved in closed form;
+    // no shared buffers, so poses can be estimated next to a running detection
+    cv::Point2f normalizedCorners[4 * Markers::CAPACITY];
+    camera->undistort(markers.corners, 4 * count, normalizedCorners);
+
+    int kept = 0;
+    for (int i = 0; i < count; ++i) {
+        const bool onBoard = MarkerBoard::anyContains(boards, markers.ids[i]);
+        cv::Matx33d rotation;
+        cv::Vec3d translation;
+        // drop the (degenerate) quads that have no pose, board markers are solved together
+        if (onBoard || SquarePose::solve(&normalizedCorners[4 * i], _d->markerLengthInMm, rotation, translation)) {
+            if (kept != i) {
+                std::copy(markers.corners + 4 * i, markers.corners + 4 * (i + 1), markers.corners + 4 * kept);
+                markers.ids[kept] = markers.ids[i];
+            }
+            markers.rvecs[kept] = onBoard ? cv::Vec3d() : SquarePose::rotationVector(rotation);
+            markers.tvecs[kept] = onBoard ? cv::Vec3d() : translation;
+            kept++;
+        }
     }
-    return results;
+    markers.count = kept;
+}
+
+void Aruco::refineCorners(QImage image, Aruco::Markers& markers, const Aruco::RefineMethod* methods) const
+{
+    if (image.size().isEmpty() || std::all_of(methods, methods + markers.count, [](RefineMethod m) { return m == NoRefinement; }))
+        return;
+
+    StageTimer timer(_d->stats, DetectionStats::Refinement);
+    _d->stats.addCount(DetectionStats::Refined, int(std::count_if(methods, methods + markers.count, [](RefineMethod m) { return m != NoRefinement; })));
+    int fullWinSize;
+    {
+        QMutexLocker lock(&_d->parametersMutex);
+        fullWinSize = _d->params.cornerRefinementWinSize;
+    }
+
+    cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
+    cv::cvtColor(view, _d->grayImage, cv::COLOR_RGB2GRAY);
+    const cv::TermCriteria fastCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, FAST_REFINEMENT_ITERATIONS, REFINEMENT_ACCURACY);
+    const cv::TermCriteria fullCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, FULL_REFINEMENT_ITERATIONS, REFINEMENT_ACCURACY);
+    for (int i = 0; i < markers.count; ++i) {
+        if (methods[i] == NoRefinement)
+            continue;
+
+        const bool full = methods[i] == FullRefinement;
+        const int winSize = full ? fullWinSize : FAST_REFINEMENT_WIN_SIZE;
+        cv::Mat corners(4, 1, CV_32FC2, markers.corners + 4 * i);
+        cv::cornerSubPix(_d->grayImage, corners, cv::Size(winSize, winSize), cv::Size(-1, -1), full ? fullCriteria : fastCriteria);
+    }
+}
+
+bool Aruco::verifyMarkers(QImage image, const Aruco::Markers& markers) const
+{
+    if (image.size().isEmpty())
+        return false;
+
+    StageTimer timer(_d->stats, DetectionStats::Verification);
+    cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
+    const int size = (MARKER_SIZE + 2) * CELL_SIZE;
+    const float last = size - 1;
+    const cv::Point2f square[4] = { { 0, 0 }, { last, 0 }, { last, last }, { 0, last } };
+    _d->markerBits.create(MARKER_SIZE, MARKER_SIZE, CV_8UC1);
+    for (int i = 0; i < markers.count; ++i) {
+        // only the marker itself is warped, so this is far cheaper than detecting it again
+        const cv::Mat transform = cv::getPerspectiveTransform(markers.corners + 4 * i, square);
+        cv::warpPerspective(view, _d->markerImage, transform, cv::Size(size, size), cv::INTER_NEAREST);
+        cv::cvtColor(_d->markerImage, _d->markerGray, cv::COLOR_RGB2GRAY);
+        cv::threshold(_d->markerGray, _d->markerBinary, 125, 1, cv::THRESH_BINARY | cv::THRESH_OTSU);
+
+        // a cell is set when most of its inner pixels are white, the black border is skipped
+        const cv::Rect inner(1, 1, CELL_SIZE - 2, CELL_SIZE - 2);
+        for (int row = 0; row < MARKER_SIZE; ++row) {
+            for (int column = 0; column < MARKER_SIZE; ++column) {
+                const cv::Rect cell = inner + cv::Point((column + 1) * CELL_SIZE, (row + 1) * CELL_SIZE);
+                _d->markerBits.at<uchar>(row, column) = 2 * cv::countNonZero(_d->markerBinary(cell)) > cell.area();
+            }
+        }
+
+        int id = -1;
+        int rotation = -1;
+        if (!_d->decoder.identify(_d->markerBits, id, rotation) || id != markers.ids[i] || rotation != 0)
+            return false;
+    }
+    return true;
+}
+
+int Aruco::estimateBoardPose(const MarkerBoard& board, const Aruco::Markers& markers, cv::Vec3d& rvec, cv::Vec3d& tvec) const
+{
+    StageTimer timer(_d->stats, DetectionStats::BoardPose);
+    _d->boardObjectPoints.clear();
+    _d->boardImagePoints.clear();
+    int found = 0;
+    for (int i = 0; i < markers.count; ++i) {
+        const int index = board.indexOf(markers.ids[i]);
+        if (index >= 0) {
+            const cv::Point3f* corners = board.corners(index);
+            _d->boardObjectPoints.insert(_d->boardObjectPoints.end(), corners, corners + 4);
+            _d->boardImagePoints.insert(_d->boardImagePoints.end(), markers.corners + 4 * i, markers.corners + 4 * (i + 1));
+            found++;
+        }
+    }
+    const QSharedPointer<const PointUndistorter> camera = _d->currentCamera();
+    if (found == 0 || !camera)
+        return 0;
+
+    // one pnp over the corners of all visible markers of the rigid object
+    const int method = board.isPlanar() ? cv::SOLVEPNP_IPPE : cv::SOLVEPNP_ITERATIVE;
+    if (!cv::solvePnP(_d->boardObjectPoints, _d->boardImagePoints, camera->cameraMatrix(), camera->distCoeffs(), rvec, tvec, false, method))
+        return 0;
+
+    return found;
 }
 
 void Aruco::drawMarkers(QImage& image, const Aruco::Markers& markers) const
 {
-    if (!image.size().isEmpty()) {
+    if (!image.size().isEmpty() && markers.count > 0) {
         cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.bits(), image.bytesPerLine());
-        cv::aruco::drawDetectedMarkers(view, markers.corners, markers.ids);
+        // one row of four corners per marker
+        const cv::Mat corners(markers.count, 4, CV_32FC2, const_cast<cv::Point2f*>(markers.corners));
+        const cv::Mat ids(markers.count, 1, CV_32SC1, const_cast<int*>(markers.ids));
+        cv::aruco::drawDetectedMarkers(view, corners, ids);
     }
 }
 
+const DetectionStats& Aruco::detectionStats() const
+{
+    return _d->stats;
+}
+
+QVariantMap Aruco::detectionStatistics() const
+{
+    return _d->stats.toVariantMap();
+}
+
+void Aruco::resetDetectionStatistics()
+{
+    _d->stats.clear();
+}
+
 void Aruco::generateMarkerImageFiles(QString path) const
 {
     // TODO
@@ -16,33 +16,108 @@
 */
 #pragma once
 #include <QImage>
+#include <QList>
 #include <QObject>
 #include <QScopedPointer>
 #include <QString>
+#include <QVariantMap>
 #include <opencv2/core/mat.hpp>
 #include <vector>
 
+class DetectionStats;
+class MarkerBoard;
+
 class Aruco : public QObject {
     Q_OBJECT
 
 public:
+    // fixed capacity, so a copy does not allocate and only copies the first count entries;
+    // the corners of marker i are corners[4 * i] up to corners[4 * i + 3]
     struct Markers {
-        std::vector<std::vector<cv::Point2f>> corners;
-        std::vector<int> ids;
-        std::vector<cv::Vec3d> rvecs, tvecs;
+        static constexpr int CAPACITY = 64;
+
+        Markers();
+        Markers(const Markers& other);
+        Markers& operator=(const Markers& other);
+
+        int count;
+        cv::Point2f corners[4 * CAPACITY];
+        int ids[CAPACITY];
+        cv::Vec3d rvecs[CAPACITY];
+        cv::Vec3d tvecs[CAPACITY];
+    };
+
+    struct DetectorParams {
+        DetectorParams(
+            int adaptiveThreshWinSizeMin = 3,
+            int adaptiveThreshWinSizeMax = 23,
+            int adaptiveThreshWinSizeStep = 10,
+            double adaptiveThreshConstant = 7,
+            double minMarkerPerimeterRate = 0.03,
+            double maxMarkerPerimeterRate = 4.0,
+            double polygonalApproxAccuracyRate = 0.03,
+            int cornerRefinementWinSize = 5);
+
+        int adaptiveThreshWinSizeMin;
+        int adaptiveThreshWinSizeMax;
+        int adaptiveThreshWinSizeStep;
+        double adaptiveThreshConstant;
+        double minMarkerPerimeterRate;
+        double maxMarkerPerimeterRate;
+        double polygonalApproxAccuracyRate;
+        int cornerRefinementWinSize;
+    };
+
+    enum RefineMethod {
+        NoRefinement,
+        FastRefinement,
+        FullRefinement
     };
 
 public:
     explicit Aruco(QObject* parent = nullptr);
     virtual ~Aruco();
 
-    void setCameraMatrix(cv::Mat cameraMatrix, cv::Mat distCoeffs);
-    Markers detectMarkers(QImage image) const;
-    std::vector<float> calc2dAngles(const Markers& markers) const;
+    // with the image size the corners are undistorted through a precomputed grid; the camera can be
+    // replaced while another thread detects or estimates poses, those finish on the previous one
+    void setCameraMatrix(cv::Mat cameraMatrix, cv::Mat distCoeffs, cv::Size imageSize = cv::Size());
+
+    // camera, detector parameters and allowed ids of other, for a detector of its own on another
+    // thread; safe while other is in use
+    void copySettings(const Aruco& other);
+
+    DetectorParams detectorParams() const;
+    void setDetectorParams(const DetectorParams& p);
+    Q_INVOKABLE bool loadDetectorParams(QString filename);
+    Q_INVOKABLE void saveDetectorParams(QString filename) const;
+
+    // only these ids are decoded, an empty list allows the whole dictionary;
+    // an id outside the dictionary fails the call and keeps the previous ids
+    QList<int> allowedIds() const;
+    Q_INVOKABLE bool setAllowedIds(QList<int> ids);
+
+    // detection, refinement and verification share buffers and must run on one thread,
+    // estimatePoses and estimateBoardPose can run on another one at the same time.
+    // detection only finds ids and corners, estimatePoses solves the poses;
+    // scale < 1 detects on a downscaled copy and maps the corners back to the full image,
+    // a depth range (in mm) rejects candidates too small or too large to be a marker at that distance
+    Markers detectMarkers(QImage image, double scale = 1.0, double nearestDepth = 0, double farthestDepth = 0) const;
+    // markers on one of the boards keep their corners for estimateBoardPose but get no pose of their own
+    void estimatePoses(Markers& markers, const std::vector<MarkerBoard>* boards = nullptr) const;
+    // detection leaves the corners unrefined, methods holds one entry per marker; poses are not updated
+    void refineCorners(QImage image, Markers& markers, const RefineMethod* methods) const;
+    // reads the bits inside every marker and checks they still decode to its id
+    bool verifyMarkers(QImage image, const Markers& markers) const;
+    int estimateBoardPose(const MarkerBoard& board, const Markers& markers, cv::Vec3d& rvec, cv::Vec3d& tvec) const;
     void drawMarkers(QImage& image, const Markers& markers) const;
 
     void generateMarkerImageFiles(QString path) const;
 
+    // rolling timing per detection stage and candidate counts, see DetectionStats::toVariantMap
+    const DetectionStats& detectionStats() const;
+    Q_INVOKABLE QVariantMap detectionStatistics() const;
+    Q_INVOKABLE void resetDetectionStatistics();
+
 private:
     struct Data;
     QScopedPointer<Data> _d;
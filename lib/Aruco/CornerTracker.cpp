@@ -0,0 +1,98 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "CornerTracker.h"
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
+namespace {
+const cv::Size WINDOW_SIZE(21, 21);
+const int MAX_PYRAMID_LEVEL = 3;
+}
+
+struct CornerTracker::Data {
+    void buildPyramid(QImage image, std::vector<cv::Mat>& pyramid)
+    {
+        cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
+        cv::cvtColor(view, gray, cv::COLOR_RGB2GRAY);
+        cv::buildOpticalFlowPyramid(gray, pyramid, WINDOW_SIZE, MAX_PYRAMID_LEVEL);
+    }
+
+    float maxFlowError;
+    bool hasReference;
+    cv::Mat gray;
+    std::vector<cv::Mat> referencePyramid;
+    std::vector<cv::Mat> pyramid;
+    std::vector<cv::Point2f> points;
+    std::vector<uchar> status;
+    std::vector<float> errors;
+};
+
+CornerTracker::CornerTracker(float maxFlowError)
+    : _d(new Data())
+{
+    _d->maxFlowError = maxFlowError;
+    _d->hasReference = false;
+}
+
+CornerTracker::~CornerTracker()
+{
+}
+
+float CornerTracker::maxFlowError() const
+{
+    return _d->maxFlowError;
+}
+
+void CornerTracker::setMaxFlowError(float maxFlowError)
+{
+    _d->maxFlowError = maxFlowError;
+}
+
+void CornerTracker::setReference(QImage image)
+{
+    _d->hasReference = !image.size().isEmpty();
+    if (_d->hasReference) {
+        _d->buildPyramid(image, _d->referencePyramid);
+    }
+}
+
+bool CornerTracker::track(QImage image, Aruco::Markers& markers)
+{
+    if (!_d->hasReference || image.size().isEmpty()) {
+        setReference(image);
+        return false;
+    }
+
+    _d->buildPyramid(image, _d->pyramid);
+
+    const int count = markers.count;
+    bool ok = count > 0;
+    if (ok) {
+        const cv::Mat referencePoints(4 * count, 1, CV_32FC2, markers.corners);
+        cv::calcOpticalFlowPyrLK(_d->referencePyramid, _d->pyramid, referencePoints, _d->points, _d->status, _d->errors, WINDOW_SIZE, MAX_PYRAMID_LEVEL);
+        for (size_t i = 0; ok && i < _d->points.size(); ++i) {
+            ok = _d->status[i] && _d->errors[i] <= _d->maxFlowError;
+        }
+    }
+    if (ok) {
+        std::copy(_d->points.cbegin(), _d->points.cend(), markers.corners);
+    }
+
+    std::swap(_d->referencePyramid, _d->pyramid);
+    return ok;
+}
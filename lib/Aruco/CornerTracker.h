@@ -0,0 +1,41 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "Aruco.h"
+#include <QImage>
+#include <QScopedPointer>
+
+// Follows the corners of already identified markers from one frame to the next using pyramidal Lucas-Kanade optical flow.
+class CornerTracker
+{
+public:
+    explicit CornerTracker(float maxFlowError = 20.0f);
+    ~CornerTracker();
+
+    float maxFlowError() const;
+    void setMaxFlowError(float maxFlowError);
+
+    // the reference is the frame the corners are tracked from
+    void setReference(QImage image);
+    // moves the corners of markers from the reference into image, which becomes the new reference.
+    // returns false when a corner was lost or its flow error exceeds maxFlowError.
+    bool track(QImage image, Aruco::Markers& markers);
+
+private:
+    struct Data;
+    QScopedPointer<Data> _d;
+};
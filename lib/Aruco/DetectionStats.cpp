@@ -0,0 +1,221 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "DetectionStats.h"
+#include <QMutexLocker>
+#include <QVariantList>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+const float TIME_BIN_WIDTH = 0.5f;
+const float COUNT_BIN_WIDTH = 5.0f;
+const int BIN_COUNT = 20;
+
+QVariantMap summary(const RollingHistogram& histogram, float binWidth)
+{
+    QVariantList bins;
+    for (int bin : histogram.bins(binWidth, BIN_COUNT)) {
+        bins << bin;
+    }
+
+    QVariantMap result;
+    result["count"] = histogram.count();
+    result["mean"] = histogram.mean();
+    result["p50"] = histogram.percentile(0.5f);
+    result["p95"] = histogram.percentile(0.95f);
+    result["max"] = histogram.max();
+    result["binWidth"] = binWidth;
+    result["bins"] = bins;
+    return result;
+}
+}
+
+RollingHistogram::RollingHistogram(int window)
+    : _window(std::max(1, window))
+    , _next(0)
+{
+    _samples.reserve(_window);
+}
+
+void RollingHistogram::add(float value)
+{
+    if (_samples.size() < _window) {
+        _samples.push_back(value);
+    } else {
+        _samples[_next] = value;
+        _next = (_next + 1) % _samples.size();
+    }
+}
+
+void RollingHistogram::clear()
+{
+    _samples.clear();
+    _next = 0;
+}
+
+int RollingHistogram::count() const
+{
+    return int(_samples.size());
+}
+
+float RollingHistogram::mean() const
+{
+    if (_samples.empty())
+        return 0;
+
+    return std::accumulate(_samples.cbegin(), _samples.cend(), 0.0f) / _samples.size();
+}
+
+float RollingHistogram::max() const
+{
+    if (_samples.empty())
+        return 0;
+
+    return *std::max_element(_samples.cbegin(), _samples.cend());
+}
+
+float RollingHistogram::percentile(float p) const
+{
+    if (_samples.empty())
+        return 0;
+
+    std::vector<float> sorted = _samples;
+    const size_t rank = std::min(sorted.size() - 1, size_t(p * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+std::vector<int> RollingHistogram::bins(float binWidth, int binCount) const
+{
+    std::vector<int> result(binCount, 0);
+    for (float sample : _samples) {
+        const int bin = std::min(binCount - 1, std::max(0, int(sample / binWidth)));
+        result[bin]++;
+    }
+    return result;
+}
+
+DetectionStats::DetectionStats(int window)
+{
+    for (auto& histogram : _stages) {
+        histogram = RollingHistogram(window);
+    }
+    for (auto& histogram : _counters) {
+        histogram = RollingHistogram(window);
+    }
+}
+
+void DetectionStats::addTime(Stage stage, float msecs)
+{
+    QMutexLocker lock(&_mutex);
+    _stages[stage].add(msecs);
+}
+
+void DetectionStats::addCount(Counter counter, int count)
+{
+    QMutexLocker lock(&_mutex);
+    _counters[counter].add(count);
+}
+
+void DetectionStats::clear()
+{
+    QMutexLocker lock(&_mutex);
+    for (auto& histogram : _stages) {
+        histogram.clear();
+    }
+    for (auto& histogram : _counters) {
+        histogram.clear();
+    }
+}
+
+RollingHistogram DetectionStats::histogram(Stage stage) const
+{
+    QMutexLocker lock(&_mutex);
+    return _stages[stage];
+}
+
+RollingHistogram DetectionStats::histogram(Counter counter) const
+{
+    QMutexLocker lock(&_mutex);
+    return _counters[counter];
+}
+
+QVariantMap DetectionStats::toVariantMap() const
+{
+    QMutexLocker lock(&_mutex);
+    QVariantMap stages;
+    for (int i = 0; i < StageCount; ++i) {
+        stages[name(Stage(i))] = summary(_stages[i], TIME_BIN_WIDTH);
+    }
+    QVariantMap counters;
+    for (int i = 0; i < CounterCount; ++i) {
+        counters[name(Counter(i))] = summary(_counters[i], COUNT_BIN_WIDTH);
+    }
+
+    QVariantMap result;
+    result["stages"] = stages;
+    result["counters"] = counters;
+    return result;
+}
+
+const char* DetectionStats::name(Stage stage)
+{
+    switch (stage) {
+    case Resize:
+        return "resize";
+    case Detection:
+        return "detection";
+    case Refinement:
+        return "refinement";
+    case Pose:
+        return "pose";
+    case BoardPose:
+        return "boardPose";
+    case Verification:
+        return "verification";
+    default:
+        return "";
+    }
+}
+
+const char* DetectionStats::name(Counter counter)
+{
+    switch (counter) {
+    case Candidates:
+        return "candidates";
+    case Identified:
+        return "identified";
+    case Refined:
+        return "refined";
+    case Dropped:
+        return "dropped";
+    default:
+        return "";
+    }
+}
+
+StageTimer::StageTimer(DetectionStats& stats, DetectionStats::Stage stage)
+    : _stats(stats)
+    , _stage(stage)
+{
+    _timer.start();
+}
+
+StageTimer::~StageTimer()
+{
+    _stats.addTime(_stage, _timer.nsecsElapsed() / 1e6f);
+}
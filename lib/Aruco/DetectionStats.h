@@ -0,0 +1,102 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QVariantMap>
+#include <vector>
+
+// Keeps the last samples of a value, statistics and histogram are computed when asked for.
+class RollingHistogram
+{
+public:
+    explicit RollingHistogram(int window = 300);
+
+    void add(float value);
+    void clear();
+
+    int count() const;
+    float mean() const;
+    float max() const;
+    // p in [0, 1], nearest rank
+    float percentile(float p) const;
+    // the last bin also counts everything above binCount * binWidth
+    std::vector<int> bins(float binWidth, int binCount) const;
+
+private:
+    size_t _window;
+    std::vector<float> _samples;
+    size_t _next;
+};
+
+// Timing of the detection stages and counts per frame, written by the tracking thread and
+// read from anywhere. cv::aruco::detectMarkers thresholds, finds candidates and identifies them
+// in one call, so those are timed together as Detection.
+class DetectionStats
+{
+public:
+    enum Stage {
+        Resize,
+        Detection,
+        Refinement,
+        Pose,
+        BoardPose,
+        Verification,
+        StageCount
+    };
+    enum Counter {
+        Candidates,
+        Identified,
+        Refined,
+        // identified beyond what Aruco::Markers holds
+        Dropped,
+        CounterCount
+    };
+
+    explicit DetectionStats(int window = 300);
+
+    void addTime(Stage stage, float msecs);
+    void addCount(Counter counter, int count);
+    void clear();
+
+    RollingHistogram histogram(Stage stage) const;
+    RollingHistogram histogram(Counter counter) const;
+
+    // { "stages": { name: summary }, "counters": { name: summary } }, times in msec
+    QVariantMap toVariantMap() const;
+
+    static const char* name(Stage stage);
+    static const char* name(Counter counter);
+
+private:
+    mutable QMutex _mutex;
+    RollingHistogram _stages[StageCount];
+    RollingHistogram _counters[CounterCount];
+};
+
+// Adds the time until it goes out of scope to a stage.
+class StageTimer
+{
+public:
+    StageTimer(DetectionStats& stats, DetectionStats::Stage stage);
+    ~StageTimer();
+
+private:
+    DetectionStats& _stats;
+    const DetectionStats::Stage _stage;
+    QElapsedTimer _timer;
+};
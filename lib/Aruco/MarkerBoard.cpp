@@ -0,0 +1,113 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MarkerBoard.h"
+#include <algorithm>
+#include <opencv2/core/persistence.hpp>
+
+MarkerBoard::MarkerBoard(int id)
+    : _id(id)
+{
+}
+
+int MarkerBoard::id() const
+{
+    return _id;
+}
+
+void MarkerBoard::addMarker(int markerId, const cv::Point3f& center, float markerLength)
+{
+    // same corner order as a single detected marker
+    const float l2 = markerLength / 2;
+    _markerIds.push_back(markerId);
+    _corners.push_back(center + cv::Point3f(-l2, l2, 0));
+    _corners.push_back(center + cv::Point3f(l2, l2, 0));
+    _corners.push_back(center + cv::Point3f(l2, -l2, 0));
+    _corners.push_back(center + cv::Point3f(-l2, -l2, 0));
+}
+
+int MarkerBoard::markerCount() const
+{
+    return int(_markerIds.size());
+}
+
+int MarkerBoard::indexOf(int markerId) const
+{
+    auto it = std::find(_markerIds.cbegin(), _markerIds.cend(), markerId);
+    return it == _markerIds.cend() ? -1 : int(it - _markerIds.cbegin());
+}
+
+bool MarkerBoard::anyContains(const std::vector<MarkerBoard>* boards, int markerId)
+{
+    if (boards) {
+        for (const auto& board : *boards) {
+            if (board.indexOf(markerId) >= 0)
+                return true;
+        }
+    }
+    return false;
+}
+
+const cv::Point3f* MarkerBoard::corners(int index) const
+{
+    return &_corners[4 * index];
+}
+
+bool MarkerBoard::isPlanar() const
+{
+    return std::all_of(_corners.cbegin(), _corners.cend(), [this](const cv::Point3f& p) {
+        return p.z == _corners.front().z;
+    });
+}
+
+// { "boards": [ { "id": 10, "markers": [ { "id": 10, "x": 0, "y": 0, "z": 0, "length": 32 }, ... ] }, ... ] }
+std::vector<MarkerBoard> MarkerBoard::load(QString filename, bool* ok)
+{
+    std::vector<MarkerBoard> result;
+    cv::FileStorage file(filename.toStdString(), cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    bool valid = file.isOpened();
+    if (valid) {
+        for (const auto& boardNode : file["boards"]) {
+            if (!boardNode["id"].isInt()) {
+                valid = false;
+                break;
+            }
+            MarkerBoard board(int(boardNode["id"]));
+            for (const auto& markerNode : boardNode["markers"]) {
+                cv::Point3f center(float(markerNode["x"]), float(markerNode["y"]), float(markerNode["z"]));
+                board.addMarker(int(markerNode["id"]), center, float(markerNode["length"]));
+            }
+            // boards share the id space of the markers, so a board takes the id of one of its own markers
+            const bool duplicate = std::any_of(result.cbegin(), result.cend(), [&board](const MarkerBoard& other) {
+                return other.id() == board.id();
+            });
+            if (duplicate || (board.markerCount() > 0 && board.indexOf(board.id()) < 0)) {
+                valid = false;
+                break;
+            }
+            if (board.markerCount() > 0) {
+                result.push_back(board);
+            }
+        }
+    }
+    if (!valid) {
+        result.clear();
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <QString>
+#include <opencv2/core/types.hpp>
+#include <vector>
+
+// A rigid object carrying several markers at known offsets in the object coordinate system.
+// The markers lie parallel to the object xy plane and face +z, like a single marker does.
+class MarkerBoard
+{
+public:
+    explicit MarkerBoard(int id = -1);
+
+    int id() const;
+
+    void addMarker(int markerId, const cv::Point3f& center, float markerLength);
+    int markerCount() const;
+    int indexOf(int markerId) const;
+    const cv::Point3f* corners(int index) const;
+    bool isPlanar() const;
+
+    // fails as a whole when a board has no id, or an id that is not one of its own markers
+    // and could therefore be a marker that is tracked on its own
+    static std::vector<MarkerBoard> load(QString filename, bool* ok = nullptr);
+    static bool anyContains(const std::vector<MarkerBoard>* boards, int markerId);
+
+private:
+    int _id;
+    std::vector<int> _markerIds;
+    std::vector<cv::Point3f> _corners;
+};
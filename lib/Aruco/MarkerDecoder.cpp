@@ -0,0 +1,91 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MarkerDecoder.h"
+#include <algorithm>
+
+MarkerDecoder<4>::MarkerDecoder(const cv::Ptr<cv::aruco::Dictionary>& dictionary, int maxCorrectionBits)
+    : _dictionary(dictionary)
+{
+    if (_dictionary->markerSize != 4)
+        return;
+
+    if (maxCorrectionBits < 0) {
+        maxCorrectionBits = _dictionary->maxCorrectionBits;
+    }
+    // more than two bits gives too many codes per pattern for a 4x4 marker anyway
+    maxCorrectionBits = std::min(maxCorrectionBits, 2);
+
+    // every code within maxCorrectionBits of a rotated pattern, there are at most 1 + 16 + 120 per pattern
+    _table.assign(1 << 16, NO_MARKER);
+    for (int id = 0; id < _dictionary->bytesList.rows; ++id) {
+        // a row holds the two bytes of each of the four rotations one after the other, rotation 0 first
+        const uchar* bytes = _dictionary->bytesList.ptr(id);
+        uint16_t pattern = uint16_t(bytes[0] << 8 | bytes[1]);
+        for (int rotation = 0; rotation < 4; ++rotation, pattern = rotate(pattern)) {
+            insert(pattern, id, rotation);
+            for (int i = 0; i < 16 && maxCorrectionBits > 0; ++i) {
+                const uint16_t once = pattern ^ uint16_t(1u << i);
+                insert(once, id, rotation);
+                for (int j = i + 1; j < 16 && maxCorrectionBits > 1; ++j) {
+                    insert(once ^ uint16_t(1u << j), id, rotation);
+                }
+            }
+        }
+    }
+}
+
+void MarkerDecoder<4>::insert(uint16_t code, int id, int rotation)
+{
+    const uint16_t entry = uint16_t((id << 2 | rotation) + 1);
+    uint16_t& current = _table[code];
+    if (current == NO_MARKER) {
+        current = entry;
+    } else if (current != entry) {
+        // nearer than the correction distance to two patterns, better to report nothing
+        current = AMBIGUOUS;
+    }
+}
+
+bool MarkerDecoder<4>::identify(const cv::Mat& bits, int& id, int& rotation) const
+{
+    if (_table.empty())
+        return _dictionary->identify(bits, id, rotation, 1.0);
+
+    uint16_t code = 0;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            if (bits.at<uchar>(row, column)) {
+                code |= bit(row, column);
+            }
+        }
+    }
+    return identify(code, id, rotation);
+}
+
+bool MarkerDecoder<4>::identify(uint16_t code, int& id, int& rotation) const
+{
+    if (_table.empty())
+        return false;
+
+    const uint16_t entry = _table[code];
+    if (entry == NO_MARKER || entry == AMBIGUOUS)
+        return false;
+
+    id = (entry - 1) >> 2;
+    rotation = (entry - 1) & 3;
+    return true;
+}
@@ -0,0 +1,96 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cstdint>
+#include <opencv2/aruco.hpp>
+#include <vector>
+
+// Identifies the bits read from the inside of a marker. Generic dictionaries go through
+// cv::aruco::Dictionary::identify, the 4x4 dictionaries are specialised below.
+template <int MarkerSize>
+class MarkerDecoder {
+public:
+    explicit MarkerDecoder(const cv::Ptr<cv::aruco::Dictionary>& dictionary)
+        : _dictionary(dictionary)
+    {
+    }
+
+    // bits is a MarkerSize x MarkerSize CV_8UC1 of zeros and ones
+    bool identify(const cv::Mat& bits, int& id, int& rotation) const
+    {
+        return _dictionary->identify(bits, id, rotation, 1.0);
+    }
+
+private:
+    cv::Ptr<cv::aruco::Dictionary> _dictionary;
+};
+
+// The 16 bits of a 4x4 marker index a lookup table that holds every rotation of every
+// dictionary pattern with up to maxCorrectionBits bits flipped, so identifying is one load.
+// Rotation is the number of clockwise quarter turns from the dictionary pattern to the bits.
+// Dictionaries of another marker size fall back to cv::aruco::Dictionary::identify.
+template <>
+class MarkerDecoder<4> {
+public:
+    explicit MarkerDecoder(const cv::Ptr<cv::aruco::Dictionary>& dictionary, int maxCorrectionBits = -1);
+
+    bool identify(const cv::Mat& bits, int& id, int& rotation) const;
+    bool identify(uint16_t code, int& id, int& rotation) const;
+
+    // bit (row, column) is stored at 15 - (4 * row + column), like the dictionary bytes
+    static constexpr uint16_t rotate(uint16_t code)
+    {
+        uint16_t result = 0;
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                // clockwise: the new (row, column) is the old (3 - column, row)
+                if (code & bit(3 - column, row)) {
+                    result |= bit(row, column);
+                }
+            }
+        }
+        return result;
+    }
+
+    static constexpr int distance(uint16_t a, uint16_t b)
+    {
+        int result = 0;
+        for (uint16_t difference = a ^ b; difference; difference &= difference - 1) {
+            result++;
+        }
+        return result;
+    }
+
+private:
+    static constexpr uint16_t bit(int row, int column)
+    {
+        return uint16_t(1u << (15 - (4 * row + column)));
+    }
+
+    static constexpr uint16_t NO_MARKER = 0;
+    static constexpr uint16_t AMBIGUOUS = 0xFFFF;
+
+    void insert(uint16_t code, int id, int rotation);
+
+    // (id << 2 | rotation) + 1 per code, or NO_MARKER / AMBIGUOUS
+    std::vector<uint16_t> _table;
+    cv::Ptr<cv::aruco::Dictionary> _dictionary;
+};
+
+static_assert(MarkerDecoder<4>::rotate(0x8000) == 0x1000, "top left moves to top right");
+static_assert(MarkerDecoder<4>::rotate(MarkerDecoder<4>::rotate(MarkerDecoder<4>::rotate(MarkerDecoder<4>::rotate(0x1234)))) == 0x1234, "four turns are identity");
+static_assert(MarkerDecoder<4>::distance(0xF0F0, 0xF0F1) == 1, "one bit differs");
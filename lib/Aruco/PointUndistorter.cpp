@@ -0,0 +1,82 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "PointUndistorter.h"
+#include <opencv2/calib3d.hpp>
+
+PointUndistorter::PointUndistorter(cv::Mat cameraMatrix, cv::Mat distCoeffs, cv::Size imageSize, int gridStep)
+    : _gridStep(gridStep)
+    , _cameraMatrix(cameraMatrix.clone())
+    , _distCoeffs(distCoeffs.clone())
+    , _imageSize(imageSize)
+    , _columns(0)
+    , _rows(0)
+{
+    if (_cameraMatrix.empty() || imageSize.empty())
+        return;
+
+    // one extra grid line past the last pixel, so every pixel has four grid neighbours
+    _columns = (imageSize.width - 1) / _gridStep + 2;
+    _rows = (imageSize.height - 1) / _gridStep + 2;
+    std::vector<cv::Point2f> pixels;
+    pixels.reserve(_columns * _rows);
+    for (int row = 0; row < _rows; ++row) {
+        for (int column = 0; column < _columns; ++column) {
+            pixels.emplace_back(float(column * _gridStep), float(row * _gridStep));
+        }
+    }
+    // the grid is built once, so it can afford to iterate to convergence
+    const cv::TermCriteria criteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 50, 1e-9);
+    cv::undistortPoints(pixels, _grid, _cameraMatrix, _distCoeffs, cv::noArray(), cv::noArray(), criteria);
+}
+
+const cv::Mat& PointUndistorter::cameraMatrix() const
+{
+    return _cameraMatrix;
+}
+
+const cv::Mat& PointUndistorter::distCoeffs() const
+{
+    return _distCoeffs;
+}
+
+cv::Size PointUndistorter::imageSize() const
+{
+    return _imageSize;
+}
+
+void PointUndistorter::undistort(const cv::Point2f* points, int count, cv::Point2f* normalized) const
+{
+    const float scale = 1.0f / _gridStep;
+    for (int i = 0; i < count; ++i) {
+        const float x = points[i].x * scale;
+        const float y = points[i].y * scale;
+        const int column = int(x);
+        const int row = int(y);
+        if (x >= 0 && y >= 0 && column + 1 < _columns && row + 1 < _rows) {
+            const float fx = x - column;
+            const float fy = y - row;
+            const cv::Point2f* cell = &_grid[row * _columns + column];
+            const cv::Point2f top = cell[0] + fx * (cell[1] - cell[0]);
+            const cv::Point2f bottom = cell[_columns] + fx * (cell[_columns + 1] - cell[_columns]);
+            normalized[i] = top + fy * (bottom - top);
+        } else if (!_cameraMatrix.empty()) {
+            const cv::Mat point(1, 1, CV_32FC2, const_cast<cv::Point2f*>(points + i));
+            cv::Mat result(1, 1, CV_32FC2, normalized + i);
+            cv::undistortPoints(point, result, _cameraMatrix, _distCoeffs);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <opencv2/core/mat.hpp>
+#include <vector>
+
+// Maps distorted pixel positions to undistorted, normalized image coordinates by bilinear
+// interpolation in a grid that is undistorted once, instead of iterating per point.
+// Points outside the grid, or without an image size, go through cv::undistortPoints.
+// It cannot change after construction: a new camera gets a new undistorter, so a thread
+// that still holds the previous one keeps a consistent grid.
+class PointUndistorter
+{
+public:
+    PointUndistorter(cv::Mat cameraMatrix, cv::Mat distCoeffs, cv::Size imageSize, int gridStep = 8);
+
+    const cv::Mat& cameraMatrix() const;
+    const cv::Mat& distCoeffs() const;
+    cv::Size imageSize() const;
+
+    void undistort(const cv::Point2f* points, int count, cv::Point2f* normalized) const;
+
+private:
+    const int _gridStep;
+    const cv::Mat _cameraMatrix;
+    const cv::Mat _distCoeffs;
+    const cv::Size _imageSize;
+    int _columns;
+    int _rows;
+    std::vector<cv::Point2f> _grid;
+};
@@ -0,0 +1,224 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "SquarePose.h"
+#include <algorithm>
+#include <math.h>
+
+namespace {
+
+// Homography mapping the unit square (0,0) (1,0) (1,1) (0,1) onto the quad
+bool unitSquareToQuad(const cv::Point2f* q, cv::Matx33d& h)
+{
+    const double sx = q[0].x - q[1].x + q[2].x - q[3].x;
+    const double sy = q[0].y - q[1].y + q[2].y - q[3].y;
+    const double dx1 = q[1].x - q[2].x;
+    const double dx2 = q[3].x - q[2].x;
+    const double dy1 = q[1].y - q[2].y;
+    const double dy2 = q[3].y - q[2].y;
+    const double det = dx1 * dy2 - dx2 * dy1;
+    if (fabs(det) < 1e-15)
+        return false;
+
+    const double g = (sx * dy2 - dx2 * sy) / det;
+    const double k = (dx1 * sy - sx * dy1) / det;
+    h = cv::Matx33d(
+        q[1].x - q[0].x + g * q[1].x, q[3].x - q[0].x + k * q[3].x, q[0].x,
+        q[1].y - q[0].y + g * q[1].y, q[3].y - q[0].y + k * q[3].y, q[0].y,
+        g, k, 1.0);
+    return true;
+}
+
+// Rotation that maps the direction (ax, ay, az) onto the z axis
+cv::Matx33d rotationToZAxis(double ax, double ay, double az)
+{
+    const double n = sqrt(ax * ax + ay * ay + az * az);
+    ax /= n;
+    ay /= n;
+    az /= n;
+    if (fabs(1.0 + az) < 1e-7) {
+        return cv::Matx33d(1, 0, 0, 0, 1, 0, 0, 0, -1);
+    }
+    const double d = 1.0 / (1.0 + az);
+    return cv::Matx33d(
+        1.0 - ax * ax * d, -ax * ay * d, -ax,
+        -ax * ay * d, 1.0 - ay * ay * d, -ay,
+        ax, ay, 1.0 - (ax * ax + ay * ay) * d);
+}
+
+// Least squares translation for a known rotation, linear in the normalized image coordinates
+bool solveTranslation(const cv::Point2f* corners, const double (*model)[2], const cv::Matx33d& r, cv::Vec3d& t)
+{
+    double su = 0, sv = 0, suv2 = 0, b0 = 0, b1 = 0, b2 = 0;
+    for (int i = 0; i < 4; ++i) {
+        const double u = corners[i].x;
+        const double v = corners[i].y;
+        const double x = model[i][0];
+        const double y = model[i][1];
+        const double px = r(0, 0) * x + r(0, 1) * y;
+        const double py = r(1, 0) * x + r(1, 1) * y;
+        const double pz = r(2, 0) * x + r(2, 1) * y;
+        const double e0 = u * pz - px;
+        const double e1 = v * pz - py;
+        su += u;
+        sv += v;
+        suv2 += u * u + v * v;
+        b0 += e0;
+        b1 += e1;
+        b2 -= u * e0 + v * e1;
+    }
+
+    // [ 4    0    -su  ]       [ b0 ]
+    // [ 0    4    -sv  ] * t = [ b1 ]
+    // [ -su  -sv  suv2 ]       [ b2 ]
+    const double det = 4.0 * suv2 - su * su - sv * sv;
+    if (fabs(det) < 1e-15)
+        return false;
+
+    t[2] = (4.0 * b2 + su * b0 + sv * b1) / det;
+    t[0] = (b0 + su * t[2]) / 4.0;
+    t[1] = (b1 + sv * t[2]) / 4.0;
+    return true;
+}
+
+double reprojectionError(const cv::Point2f* corners, const double (*model)[2], const cv::Matx33d& r, const cv::Vec3d& t)
+{
+    double error = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const double x = model[i][0];
+        const double y = model[i][1];
+        const double px = r(0, 0) * x + r(0, 1) * y + t[0];
+        const double py = r(1, 0) * x + r(1, 1) * y + t[1];
+        const double pz = r(2, 0) * x + r(2, 1) * y + t[2];
+        const double du = px / pz - corners[i].x;
+        const double dv = py / pz - corners[i].y;
+        error += du * du + dv * dv;
+    }
+    return error;
+}
+}
+
+bool SquarePose::solve(const cv::Point2f* corners, double markerLength, cv::Matx33d& rotation, cv::Vec3d& translation)
+{
+    const double l2 = markerLength / 2.0;
+    const double model[4][2] = { { -l2, l2 }, { l2, l2 }, { l2, -l2 }, { -l2, -l2 } };
+
+    cv::Matx33d hu;
+    if (!unitSquareToQuad(corners, hu))
+        return false;
+
+    // homography from the marker plane: compose with the model to unit square mapping
+    //     [ 1/L  0     1/2 ]
+    // A = [ 0    -1/L  1/2 ]
+    //     [ 0    0     1   ]
+    double h[3][3];
+    for (int i = 0; i < 3; ++i) {
+        h[i][0] = hu(i, 0) / markerLength;
+        h[i][1] = -hu(i, 1) / markerLength;
+        h[i][2] = 0.5 * (hu(i, 0) + hu(i, 1)) + hu(i, 2);
+    }
+    if (fabs(h[2][2]) < 1e-15)
+        return false;
+
+    // image of the marker center and the jacobian of the homography there
+    const double p = h[0][2] / h[2][2];
+    const double q = h[1][2] / h[2][2];
+    const double j00 = (h[0][0] - p * h[2][0]) / h[2][2];
+    const double j01 = (h[0][1] - p * h[2][1]) / h[2][2];
+    const double j10 = (h[1][0] - q * h[2][0]) / h[2][2];
+    const double j11 = (h[1][1] - q * h[2][1]) / h[2][2];
+
+    // in a frame where the line of sight to the center is the z axis, J = B * Rtop / tz
+    const cv::Matx33d rv = rotationToZAxis(p, q, 1.0);
+    const double b00 = rv(0, 0) - p * rv(0, 2);
+    const double b01 = rv(1, 0) - p * rv(1, 2);
+    const double b10 = rv(0, 1) - q * rv(0, 2);
+    const double b11 = rv(1, 1) - q * rv(1, 2);
+    const double bdet = b00 * b11 - b01 * b10;
+    if (fabs(bdet) < 1e-15)
+        return false;
+
+    const double a00 = (b11 * j00 - b01 * j10) / bdet;
+    const double a01 = (b11 * j01 - b01 * j11) / bdet;
+    const double a10 = (-b10 * j00 + b00 * j10) / bdet;
+    const double a11 = (-b10 * j01 + b00 * j11) / bdet;
+
+    // largest singular value of A is 1 / tz
+    const double ata00 = a00 * a00 + a10 * a10;
+    const double ata01 = a00 * a01 + a10 * a11;
+    const double ata11 = a01 * a01 + a11 * a11;
+    const double gamma2 = 0.5 * (ata00 + ata11 + sqrt((ata00 - ata11) * (ata00 - ata11) + 4.0 * ata01 * ata01));
+    if (gamma2 < 1e-30)
+        return false;
+
+    const double gamma = sqrt(gamma2);
+    const double r00 = a00 / gamma;
+    const double r01 = a01 / gamma;
+    const double r10 = a10 / gamma;
+    const double r11 = a11 / gamma;
+    const double c0 = sqrt(std::max(0.0, 1.0 - r00 * r00 - r10 * r10));
+    double c1 = sqrt(std::max(0.0, 1.0 - r01 * r01 - r11 * r11));
+    if (r00 * r01 + r10 * r11 > 0) {
+        c1 = -c1;
+    }
+
+    // the two ambiguous solutions differ in the sign of the out of plane components
+    double bestError = -1.0;
+    for (double sign : { 1.0, -1.0 }) {
+        const cv::Vec3d col0(r00, r10, sign * c0);
+        const cv::Vec3d col1(r01, r11, sign * c1);
+        const cv::Vec3d col2 = col0.cross(col1);
+        const cv::Matx33d local(
+            col0[0], col1[0], col2[0],
+            col0[1], col1[1], col2[1],
+            col0[2], col1[2], col2[2]);
+        const cv::Matx33d r = rv.t() * local;
+
+        cv::Vec3d t;
+        if (solveTranslation(corners, model, r, t) && t[2] > 0) {
+            const double error = reprojectionError(corners, model, r, t);
+            if (bestError < 0 || error < bestError) {
+                bestError = error;
+                rotation = r;
+                translation = t;
+            }
+        }
+    }
+    return bestError >= 0;
+}
+
+cv::Vec3d SquarePose::rotationVector(const cv::Matx33d& r)
+{
+    cv::Vec3d result(r(2, 1) - r(1, 2), r(0, 2) - r(2, 0), r(1, 0) - r(0, 1));
+    const double s = 0.5 * sqrt(result.dot(result));
+    const double c = std::min(1.0, std::max(-1.0, 0.5 * (r(0, 0) + r(1, 1) + r(2, 2) - 1.0)));
+
+    if (s >= 1e-5) {
+        return result * (acos(c) / (2.0 * s));
+    }
+    if (c > 0) {
+        return cv::Vec3d(0, 0, 0);
+    }
+
+    // rotation of pi: the axis follows from the diagonal
+    result[0] = sqrt(std::max(0.0, (r(0, 0) + 1.0) * 0.5));
+    result[1] = sqrt(std::max(0.0, (r(1, 1) + 1.0) * 0.5)) * (r(0, 1) < 0 ? -1.0 : 1.0);
+    result[2] = sqrt(std::max(0.0, (r(2, 2) + 1.0) * 0.5)) * (r(0, 2) < 0 ? -1.0 : 1.0);
+    if (fabs(result[0]) < fabs(result[1]) && fabs(result[0]) < fabs(result[2]) && (r(1, 2) > 0) != (result[1] * result[2] > 0)) {
+        result[2] = -result[2];
+    }
+    return result * (M_PI / sqrt(result.dot(result)));
+}
@@ -0,0 +1,30 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <opencv2/core/matx.hpp>
+#include <opencv2/core/types.hpp>
+
+// Closed form pose of a square marker, following IPPE (Collins & Bartoli, Infinitesimal Plane-based Pose Estimation).
+// Corners are undistorted, normalized image coordinates in aruco order: top-left, top-right, bottom-right, bottom-left.
+// The marker coordinate system has its origin in the marker center with z pointing out, as in cv::aruco.
+class SquarePose
+{
+public:
+    static bool solve(const cv::Point2f* corners, double markerLength, cv::Matx33d& rotation, cv::Vec3d& translation);
+
+    static cv::Vec3d rotationVector(const cv::Matx33d& rotation);
+};
@@ -18,6 +18,7 @@
 #include "Aruco/Aruco.h"
 #include "CameraCalibration.h"
 #include "FramesCalibrationModel.h"
+#include "Track3d/ObjectTracker.h"
 #include "Video/Frame.h"
 #include "Video/Video.h"
 #include <QDir>
@@ -26,14 +27,18 @@
 namespace {
 const QString LOADPATH_KEY(QStringLiteral("CalibrationPath"));
 const QString SAVEFILENAME_KEY(QStringLiteral("CalibrationFile"));
+const QString DETECTOR_PARAMS_FILENAME(QStringLiteral("DetectorParams.json"));
+const QString BOARDS_FILENAME(QStringLiteral("Boards.json"));
 }
 
 CalibrationController::CalibrationController(QObject* parent)
     : QObject(parent)
     , _video(new Video(this))
     , _frameIndex(-1)
+    , _showUndistorted(false)
     , _model(new FramesCalibrationModel(this))
     , _calibration(new CameraCalibration())
+    , _objectTracker(nullptr)
 {
     QSettings settings;
     setLoadPath(settings.value(LOADPATH_KEY, QDir::homePath()).toString());
@@ -52,20 +57,43 @@ Aruco* CalibrationController::aruco() const
     return _aruco;
 }
 
+ObjectTracker* CalibrationController::objectTracker() const
+{
+    return _objectTracker;
+}
+
 void CalibrationController::setFrameIndex(int index)
 {
     if (_frameIndex != index) {
         _frameIndex = index;
+        refreshImage();
+        emit frameIndexChanged(_frameIndex);
+    }
+}
+
+void CalibrationController::setShowUndistorted(bool showUndistorted)
+{
+    if (_showUndistorted == showUndistorted)
+        return;
+
+    _showUndistorted = showUndistorted;
+    refreshImage();
+    emit showUndistortedChanged(_showUndistorted);
+}
 
-        if (_frameIndex >= 0 && _frameIndex < _video->frames().length()) {
-            _image = _video->frames().at(index)->image();
-            _calibration->annotateCheckerBoard(_image);
-        } else {
-            _image = QImage();
+void CalibrationController::refreshImage()
+{
+    if (_frameIndex >= 0 && _frameIndex < _video->frames().length()) {
+        const QImage frameImage = _video->frames().at(_frameIndex)->image();
+        // annotating detaches _image, the frame of the recording is never drawn on
+        if (!_showUndistorted || !_calibration->undistortImage(frameImage, _image)) {
+            _image = frameImage;
         }
-        emit frameIndexChanged(_frameIndex);
-        emit imageChanged(_image);
+        _calibration->annotateCheckerBoard(_image);
+    } else {
+        _image = QImage();
     }
+    emit imageChanged(_image);
 }
 
 void CalibrationController::setTotalError(QString totalError)
@@ -112,6 +140,11 @@ QImage CalibrationController::image() const
     return _image;
 }
 
+bool CalibrationController::showUndistorted() const
+{
+    return _showUndistorted;
+}
+
 int CalibrationController::frameIndex() const
 {
     return _frameIndex;
@@ -126,10 +159,13 @@ void CalibrationController::calibrate()
 {
     double error = _calibration->calibrateUsingVideo(_video->frames());
     if (_aruco) {
-        _aruco->setCameraMatrix(_calibration->cameraMatrix(), _calibration->distCoeffs());
+        _aruco->setCameraMatrix(_calibration->cameraMatrix(), _calibration->distCoeffs(), _calibration->imageSize());
     }
     setCalibrationValues(_calibration->calibrationValues());
     setTotalError(QStringLiteral("RMS error: %1").arg(error));
+    if (_showUndistorted) {
+        refreshImage();
+    }
 }
 
 QString CalibrationController::totalError() const
@@ -148,10 +184,29 @@ void CalibrationController::loadCalibration()
     if (QFile::exists(filename)) {
         _calibration->load(filename);
         if (_aruco) {
-            _aruco->setCameraMatrix(_calibration->cameraMatrix(), _calibration->distCoeffs());
+            _aruco->setCameraMatrix(_calibration->cameraMatrix(), _calibration->distCoeffs(), _calibration->imageSize());
         }
         setCalibrationValues(_calibration->calibrationValues());
         setTotalError(QString());
+        if (_showUndistorted) {
+            refreshImage();
+        }
+    }
+}
+
+void CalibrationController::loadDetectorParams()
+{
+    QString filename = QDir(_loadPath).absoluteFilePath(DETECTOR_PARAMS_FILENAME);
+    if (_aruco && QFile::exists(filename)) {
+        _aruco->loadDetectorParams(filename);
+    }
+}
+
+void CalibrationController::loadBoards()
+{
+    QString filename = QDir(_loadPath).absoluteFilePath(BOARDS_FILENAME);
+    if (_objectTracker && QFile::exists(filename)) {
+        _objectTracker->loadBoards(filename);
     }
 }
 
@@ -182,3 +237,12 @@ void CalibrationController::setAruco(Aruco* aruco)
     _aruco = aruco;
     emit arucoChanged(_aruco);
 }
+
+void CalibrationController::setObjectTracker(ObjectTracker* objectTracker)
+{
+    if (_objectTracker == objectTracker)
+        return;
+
+    _objectTracker = objectTracker;
+    emit objectTrackerChanged(_objectTracker);
+}
@@ -19,6 +19,7 @@
 #include <QObject>
 
 class Aruco;
+class ObjectTracker;
 class Video;
 class FramesCalibrationModel;
 class CameraCalibration;
@@ -26,10 +27,12 @@ class CameraCalibration;
 class CalibrationController : public QObject {
     Q_OBJECT
     Q_PROPERTY(Aruco* aruco READ aruco WRITE setAruco NOTIFY arucoChanged)
+    Q_PROPERTY(ObjectTracker* objectTracker READ objectTracker WRITE setObjectTracker NOTIFY objectTrackerChanged)
     Q_PROPERTY(QString loadPath READ loadPath WRITE setLoadPath NOTIFY loadPathChanged)
     Q_PROPERTY(QString saveFilename READ saveFilename WRITE setSaveFilename NOTIFY saveFilenameChanged)
     Q_PROPERTY(int frameIndex READ frameIndex WRITE setFrameIndex NOTIFY frameIndexChanged)
     Q_PROPERTY(QImage image READ image NOTIFY imageChanged)
+    Q_PROPERTY(bool showUndistorted READ showUndistorted WRITE setShowUndistorted NOTIFY showUndistortedChanged)
     Q_PROPERTY(FramesCalibrationModel* model READ model CONSTANT)
     Q_PROPERTY(QString totalError READ totalError NOTIFY totalErrorChanged)
     Q_PROPERTY(QString calibrationValues READ calibrationValues NOTIFY calibrationValuesChanged)
@@ -39,12 +42,15 @@ public:
     virtual ~CalibrationController() override;
 
     Aruco* aruco() const;
+    ObjectTracker* objectTracker() const;
 
     QString loadPath() const;
     QString saveFilename() const;
 
     QImage image() const;
     int frameIndex() const;
+    // preview the frames through the current calibration
+    bool showUndistorted() const;
 
     FramesCalibrationModel* model() const;
 
@@ -53,33 +59,44 @@ public:
     QString totalError() const;
     Q_INVOKABLE void saveCalibration();
     Q_INVOKABLE void loadCalibration();
+    Q_INVOKABLE void loadDetectorParams();
+    Q_INVOKABLE void loadBoards();
 
 public slots:
     void setAruco(Aruco* aruco);
+    void setObjectTracker(ObjectTracker* objectTracker);
     void setLoadPath(QString loadPath);
     void setSaveFilename(QString saveFilename);
     void setFrameIndex(int index);
+    void setShowUndistorted(bool showUndistorted);
     void setTotalError(QString totalError);
     void setCalibrationValues(QString calibrationValues);
 
 signals:
     void arucoChanged(Aruco* aruco);
+    void objectTrackerChanged(ObjectTracker* objectTracker);
     void loadPathChanged(QString loadPath);
     void saveFilenameChanged(QString saveFilename);
     void imageChanged(QImage image);
     void frameIndexChanged(int index);
+    void showUndistortedChanged(bool showUndistorted);
     void totalErrorChanged(QString totalError);
     void calibrationValuesChanged(QString calibrationValues);
 
+private:
+    void refreshImage();
+
 private:
     QString _loadPath;
     QString _saveFilename;
     Video* _video;
     QImage _image;
     int _frameIndex;
+    bool _showUndistorted;
     FramesCalibrationModel* _model;
     CameraCalibration* _calibration;
     QString _totalError;
     QString _calibrationValues;
     Aruco* _aruco;
+    ObjectTracker* _objectTracker;
 };
@@ -92,7 +92,8 @@ void collectChessboardCorners(reduceResult& output, const indexedImageCornersRes
 
 struct CameraCalibrationData {
     cv::Size inputImageSize;
-    cv::Mat mapX, mapY;
+    // fixed point maps: CV_16SC2 integer positions plus CV_16UC1 interpolation table indices
+    cv::Mat mapXY, mapInterpolation;
     cv::Mat cameraMatrix;
     cv::Mat distCoeffs;
 };
@@ -113,15 +114,15 @@ void CameraCalibration::annotateCheckerBoard(QImage& image)
 
     imageCornersResult result = getChessboardCorners(image);
 
-    cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
+    cv::Mat view(image.height(), image.width(), CV_8UC3, image.bits(), image.bytesPerLine());
     cv::drawChessboardCorners(view, PATTERN_SIZE, cv::Mat(result.imageCorners), result.patternFound);
 }
 
 double CameraCalibration::calibrateUsingVideo(QList<Frame*> frames)
 {
     double error = 0.0;
-    _d->mapX = cv::Mat();
-    _d->mapY = cv::Mat();
+    _d->mapXY = cv::Mat();
+    _d->mapInterpolation = cv::Mat();
 
     if (frames.count()) {
         auto s = frames.first()->image().size();
@@ -164,23 +165,13 @@ double CameraCalibration::calibrateUsingVideo(QList<Frame*> frames)
         //        for (size_t i = 0; i < result.indices.size(); ++i) {
         //            frames.at(result.indices.at(i))->setChessBoardReprojectionError(QString::number(perViewErrors.at(i)));
         //        }
-
-        cv::initUndistortRectifyMap(
-            _d->cameraMatrix,
-            _d->distCoeffs,
-            cv::Mat(),
-            cv::Mat(),
-            _d->inputImageSize,
-            CV_32FC1,
-            _d->mapX,
-            _d->mapY);
     }
     return error;
 }
 
 void CameraCalibration::save(QString filename)
 {
-    if (!_d->mapX.empty() && !_d->mapY.empty()) {
+    if (!_d->cameraMatrix.empty() && !_d->distCoeffs.empty()) {
         cv::FileStorage file(filename.toStdString(), cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
         file << "cameraMatrix" << _d->cameraMatrix;
         file << "distCoeffs" << _d->distCoeffs;
@@ -195,24 +186,36 @@ void CameraCalibration::load(QString filename)
     file["distCoeffs"] >> _d->distCoeffs;
 
     file["inputImageSize"] >> _d->inputImageSize;
-    cv::initUndistortRectifyMap(
-        _d->cameraMatrix,
-        _d->distCoeffs,
-        cv::Mat(),
-        cv::Mat(),
-        _d->inputImageSize,
-        CV_32FC1,
-        _d->mapX,
-        _d->mapY);
+    _d->mapXY = cv::Mat();
+    _d->mapInterpolation = cv::Mat();
 }
 
-void CameraCalibration::undistortImage(QImage& image)
+bool CameraCalibration::undistortImage(const QImage& image, QImage& output)
 {
-    if (!image.size().isEmpty() && !_d->mapX.empty() && !_d->mapY.empty()) {
-        cv::Mat view(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
-        cv::Mat source = view.clone();
-        cv::remap(source, view, _d->mapX, _d->mapY, cv::INTER_LINEAR);
+    if (image.size().isEmpty() || _d->cameraMatrix.empty() || _d->distCoeffs.empty())
+        return false;
+
+    if (_d->mapXY.empty() || _d->mapInterpolation.empty()) {
+        cv::initUndistortRectifyMap(
+            _d->cameraMatrix,
+            _d->distCoeffs,
+            cv::Mat(),
+            cv::Mat(),
+            _d->inputImageSize,
+            CV_16SC2,
+            _d->mapXY,
+            _d->mapInterpolation);
     }
+    if (_d->mapXY.size() != cv::Size(image.width(), image.height()) || image.format() != QImage::Format_RGB888)
+        return false;
+
+    output = QImage(image.size(), image.format());
+
+    // remap splits the rows over its own threads
+    const cv::Mat source(image.height(), image.width(), CV_8UC3, (void*)image.constBits(), image.bytesPerLine());
+    cv::Mat destination(output.height(), output.width(), CV_8UC3, output.bits(), output.bytesPerLine());
+    cv::remap(source, destination, _d->mapXY, _d->mapInterpolation, cv::INTER_LINEAR);
+    return true;
 }
 
 cv::Mat CameraCalibration::cameraMatrix() const
@@ -225,6 +228,11 @@ cv::Mat CameraCalibration::distCoeffs() const
     return _d->distCoeffs;
 }
 
+cv::Size CameraCalibration::imageSize() const
+{
+    return _d->inputImageSize;
+}
+
 QString CameraCalibration::calibrationValues() const
 {
     if (_d->cameraMatrix.empty() || _d->distCoeffs.empty())
@@ -28,16 +28,20 @@ public:
     CameraCalibration();
     ~CameraCalibration();
 
+    // draws into image, which detaches first when its pixels are shared
     void annotateCheckerBoard(QImage& image);
 
     double calibrateUsingVideo(QList<Frame*> frames);
     void save(QString filename);
     void load(QString filename);
 
-    void undistortImage(QImage& image);
+    // for the calibration preview, tracking only undistorts marker corners; the remap maps are
+    // built on the first call and output is always a new image
+    bool undistortImage(const QImage& image, QImage& output);
 
     cv::Mat cameraMatrix() const;
     cv::Mat distCoeffs() const;
+    cv::Size imageSize() const;
 
     QString calibrationValues() const;
 
@@ -43,7 +43,7 @@ public:
     static bool isValidDevice(QString deviceName);
 
 signals:
-    void frameRead(const QImage image, QElapsedTimer timer);
+    void frameRead(const QImage image, qint64 timestampUsecs, QElapsedTimer timer);
 
 private:
     void updateExposure();
@@ -63,7 +63,7 @@ signals:
     void gainChanged(int value);
     void canCameraStreamChanged(bool canCameraStream);
     void isCameraStreamingChanged(bool isCameraStreaming);
-    void imageChanged(QImage image);
+    void imageChanged(QImage image, qint64 timestampUsecs);
 
 private slots:
     void setConnectPossible(bool connectPossible);
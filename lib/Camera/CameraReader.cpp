@@ -22,6 +22,7 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/select.h>
+#include <time.h>
 #include <unistd.h>
 
 int xioctl(int fd, int request, void* arg)
@@ -150,6 +151,16 @@ bool CameraReader::readFrame()
     QElapsedTimer timer;
     timer.start();
 
+    // the driver stamps the buffer when the frame was captured, older drivers may not
+    qint64 timestampUsecs;
+    if ((buffer.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        timestampUsecs = qint64(buffer.timestamp.tv_sec) * 1000000 + buffer.timestamp.tv_usec;
+    } else {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timestampUsecs = qint64(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+    }
+
     auto jpgBuffera = reinterpret_cast<const uchar*>(_buffers.at(buffer.index).start);
     QImage img = QImage::fromData(jpgBuffera, _buffers.at(buffer.index).length, "JPG");
     img = img.convertToFormat(QImage::Format_RGB888);
@@ -159,7 +170,7 @@ bool CameraReader::readFrame()
         qCritical() << "VIDIOC_QBUF error, errno: " << errno;
     }
 
-    emit frameRead(img, timer);
+    emit frameRead(img, timestampUsecs, timer);
     return true;
 }
 
@@ -31,7 +31,8 @@ public:
     virtual ~CameraReader();
 
 signals:
-    void frameRead(const QImage img, QElapsedTimer timer);
+    // timestamp of the capture on the monotonic clock
+    void frameRead(const QImage img, qint64 timestampUsecs, QElapsedTimer timer);
 
 protected:
     virtual void run() override;
@@ -0,0 +1,135 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <opencv2/core.hpp>
+
+// Linear Kalman filter on fixed-size matrices, nothing is allocated. Same equations as
+// cv::KalmanFilter without control input: predict continues from the last predicted or
+// corrected state, so several predictions in a row extrapolate further.
+template <int State, int Meas>
+class KalmanFilter
+{
+public:
+    using StateVector = cv::Vec<double, State>;
+    using MeasVector = cv::Vec<double, Meas>;
+    using StateMatrix = cv::Matx<double, State, State>;
+
+    KalmanFilter()
+        : transition(StateMatrix::eye())
+        , processNoise(StateMatrix::eye())
+        , measurementNoise(cv::Matx<double, Meas, Meas>::eye())
+    {
+    }
+
+    void reset(const StateVector& x)
+    {
+        state = x;
+        errorCov = StateMatrix::eye();
+    }
+
+    const StateVector& predict()
+    {
+        state = transition * state;
+        errorCov = transition * errorCov * transition.t() + processNoise;
+        return state;
+    }
+
+    const StateVector& correct(const MeasVector& z)
+    {
+        const cv::Matx<double, Meas, State> hp = measurement * errorCov;
+        const cv::Matx<double, Meas, Meas> s = hp * measurement.t() + measurementNoise;
+        // gain transposed, s is symmetric
+        const cv::Matx<double, Meas, State> gainT = s.solve(hp, cv::DECOMP_SVD);
+        state += gainT.t() * (z - measurement * state);
+        errorCov -= gainT.t() * hp;
+        return state;
+    }
+
+    StateMatrix transition;
+    StateMatrix processNoise;
+    cv::Matx<double, Meas, State> measurement;
+    cv::Matx<double, Meas, Meas> measurementNoise;
+    StateVector state;
+    StateMatrix errorCov;
+};
+
+// Position and velocity along one axis with a position measurement, the block every constant
+// velocity tracker is made of: with diagonal noise the axes never couple, so a 3D tracker is
+// three of these instead of one 6x6 filter. Written out for the symmetric 2x2 covariance.
+template <>
+class KalmanFilter<2, 1>
+{
+public:
+    using StateVector = cv::Vec2d;
+    using MeasVector = cv::Vec<double, 1>;
+    using StateMatrix = cv::Matx22d;
+
+    KalmanFilter()
+        : positionNoise(1)
+        , velocityNoise(1)
+        , measurementNoise(1)
+        , _p00(0)
+        , _p01(0)
+        , _p11(0)
+    {
+    }
+
+    void reset(double position)
+    {
+        state = StateVector(position, 0);
+        _p00 = _p11 = 1;
+        _p01 = 0;
+    }
+
+    const StateVector& predict(double dt)
+    {
+        state[0] += dt * state[1];
+        _p00 += dt * (2 * _p01 + dt * _p11) + positionNoise;
+        _p01 += dt * _p11;
+        _p11 += velocityNoise;
+        return state;
+    }
+
+    const StateVector& correct(double z)
+    {
+        const double s = _p00 + measurementNoise;
+        const double k0 = _p00 / s;
+        const double k1 = _p01 / s;
+        const double innovation = z - state[0];
+        state[0] += k0 * innovation;
+        state[1] += k1 * innovation;
+        _p11 -= k1 * _p01;
+        _p01 -= k1 * _p00;
+        _p00 -= k0 * _p00;
+        return state;
+    }
+
+    StateMatrix errorCov() const
+    {
+        return StateMatrix(_p00, _p01, _p01, _p11);
+    }
+
+    double positionNoise;
+    double velocityNoise;
+    double measurementNoise;
+    StateVector state;
+
+private:
+    double _p00;
+    double _p01;
+    double _p11;
+};
@@ -0,0 +1,152 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "KalmanFilterBank.h"
+#include <algorithm>
+
+KalmanFilterBank::KalmanFilterBank(const KalmanTracker3D::Params& p)
+    : _useTimeout(p.useTimeout)
+    , _timeout(p.notUpdatedTimeoutInMsec)
+{
+    for (int axis = X; axis < Z; ++axis) {
+        _axes[axis].positionNoise = p.positionXYProcessNoiseCov;
+        _axes[axis].velocityNoise = p.velocityXYProcessNoiseCov;
+        _axes[axis].measurementNoise = p.measurementXYNoiseCov;
+    }
+    _axes[Z].positionNoise = p.positionZProcessNoiseCov;
+    _axes[Z].velocityNoise = p.velocityZProcessNoiseCov;
+    _axes[Z].measurementNoise = p.measurementZNoiseCov;
+}
+
+int KalmanFilterBank::size() const
+{
+    return int(_notFoundCountDown.size());
+}
+
+int KalmanFilterBank::add()
+{
+    for (auto& axis : _axes) {
+        axis.position.push_back(0);
+        axis.velocity.push_back(0);
+        axis.p00.push_back(0);
+        axis.p01.push_back(0);
+        axis.p11.push_back(0);
+        axis.measurement.push_back(0);
+    }
+    _notFoundCountDown.push_back(0);
+    _measured.push_back(0);
+    return size() - 1;
+}
+
+void KalmanFilterBank::remove(int track)
+{
+    auto removeAt = [track](auto& values) {
+        values[track] = values.back();
+        values.pop_back();
+    };
+    for (auto& axis : _axes) {
+        removeAt(axis.position);
+        removeAt(axis.velocity);
+        removeAt(axis.p00);
+        removeAt(axis.p01);
+        removeAt(axis.p11);
+        removeAt(axis.measurement);
+    }
+    removeAt(_notFoundCountDown);
+    removeAt(_measured);
+}
+
+void KalmanFilterBank::setMeasurement(int track, const QVector3D& position)
+{
+    for (int axis = X; axis < AxisCount; ++axis) {
+        _axes[axis].measurement[track] = position[axis];
+    }
+    _measured[track] = 1;
+}
+
+void KalmanFilterBank::step(double elapsedMsec)
+{
+    const int n = size();
+    double* countDown = _notFoundCountDown.data();
+    const uint8_t* measured = _measured.data();
+    const double decrement = _useTimeout ? elapsedMsec : 0;
+    const double dt = elapsedMsec;
+
+    for (int i = 0; i < n; ++i) {
+        countDown[i] -= decrement;
+    }
+
+    for (auto& axis : _axes) {
+        double* x = axis.position.data();
+        double* v = axis.velocity.data();
+        double* p00 = axis.p00.data();
+        double* p01 = axis.p01.data();
+        double* p11 = axis.p11.data();
+        const double* z = axis.measurement.data();
+        const double q0 = axis.positionNoise;
+        const double q1 = axis.velocityNoise;
+        const double r = axis.measurementNoise;
+
+        // predict the tracks that have not timed out
+        for (int i = 0; i < n; ++i) {
+            const bool active = countDown[i] > 0;
+            const double predictedP00 = p00[i] + (dt * (2 * p01[i] + dt * p11[i]) + q0);
+            const double predictedP01 = p01[i] + dt * p11[i];
+            x[i] = active ? x[i] + dt * v[i] : x[i];
+            p00[i] = active ? predictedP00 : p00[i];
+            p01[i] = active ? predictedP01 : p01[i];
+            p11[i] = active ? p11[i] + q1 : p11[i];
+        }
+
+        // correct the measured tracks, restart the timed out ones from their measurement
+        for (int i = 0; i < n; ++i) {
+            const bool restart = countDown[i] <= 0;
+            const bool update = measured[i] != 0;
+            const double s = p00[i] + r;
+            const double k0 = p00[i] / s;
+            const double k1 = p01[i] / s;
+            const double innovation = z[i] - x[i];
+            const double correctedP11 = p11[i] - k1 * p01[i];
+            const double correctedP01 = p01[i] - k1 * p00[i];
+            const double correctedP00 = p00[i] - k0 * p00[i];
+            x[i] = !update ? x[i] : restart ? z[i] : x[i] + k0 * innovation;
+            v[i] = !update ? v[i] : restart ? 0 : v[i] + k1 * innovation;
+            p00[i] = !update ? p00[i] : restart ? 1 : correctedP00;
+            p01[i] = !update ? p01[i] : restart ? 0 : correctedP01;
+            p11[i] = !update ? p11[i] : restart ? 1 : correctedP11;
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        countDown[i] = measured[i] ? _timeout : countDown[i];
+    }
+    std::fill(_measured.begin(), _measured.end(), 0);
+}
+
+bool KalmanFilterBank::hasPosition(int track) const
+{
+    return _notFoundCountDown[track] > 0;
+}
+
+QVector3D KalmanFilterBank::position(int track) const
+{
+    return QVector3D(_axes[X].position[track], _axes[Y].position[track], _axes[Z].position[track]);
+}
+
+QVector3D KalmanFilterBank::velocity(int track) const
+{
+    return QVector3D(_axes[X].velocity[track], _axes[Y].velocity[track], _axes[Z].velocity[track]);
+}
@@ -0,0 +1,72 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "KalmanTracker3D.h"
+#include <QVector3D>
+#include <cstdint>
+#include <vector>
+
+// The position filters of all tracks, stored per axis in contiguous arrays so one step updates
+// every track in a few branch free loops the compiler vectorises. Each axis is the
+// position/velocity block of KalmanFilter<2, 1> and a track follows the same rules as a
+// KalmanTracker3D: predicted every step, corrected when measured, restarted from the
+// measurement after the timeout.
+class KalmanFilterBank {
+public:
+    enum Axis {
+        X,
+        Y,
+        Z,
+        AxisCount
+    };
+
+    explicit KalmanFilterBank(const KalmanTracker3D::Params& p = KalmanTracker3D::movingTanksParams());
+
+    int size() const;
+    // appends a track without position and returns its index
+    int add();
+    // the last track moves into the index of the removed one
+    void remove(int track);
+
+    // measurement for the next step, tracks without one only predict
+    void setMeasurement(int track, const QVector3D& position);
+    void step(double elapsedMsec);
+
+    bool hasPosition(int track) const;
+    QVector3D position(int track) const;
+    // per millisecond
+    QVector3D velocity(int track) const;
+
+private:
+    struct AxisFilters {
+        double positionNoise;
+        double velocityNoise;
+        double measurementNoise;
+        std::vector<double> position;
+        std::vector<double> velocity;
+        std::vector<double> p00;
+        std::vector<double> p01;
+        std::vector<double> p11;
+        std::vector<double> measurement;
+    };
+
+    AxisFilters _axes[AxisCount];
+    bool _useTimeout;
+    double _timeout;
+    std::vector<double> _notFoundCountDown;
+    std::vector<uint8_t> _measured;
+};
@@ -15,13 +15,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "KalmanTracker1D.h"
-#include <opencv2/video/tracking.hpp>
-
-namespace {
-const int stateSize = 2;
-const int measSize = 1;
-const int contrSize = 0;
-}
+#include "KalmanFilter.h"
 
 KalmanTracker1D::Params::Params(double positionProcessNoiseCov, double velocityProcessNoiseCov, double measurementNoiseCov, double notUpdatedTimeoutInMsec)
     : positionProcessNoiseCov(positionProcessNoiseCov)
@@ -34,43 +28,24 @@ KalmanTracker1D::Params::Params(double positionProcessNoiseCov, double velocityP
 struct KalmanTracker1D::Data {
     Data(const KalmanTracker1D::Params& p)
         : p(p)
-        , kf(stateSize, measSize, contrSize, CV_64F)
-        , state(stateSize, 1, CV_64F)
-        , meas(measSize, 1, CV_64F)
         , notFoundCountDown(0)
     {
-        // Transition State Matrix A
-        //   p v
-        // p 1 dT
-        // v 0 1
-        // Note: set dT at each processing step!
-        //
-        // Is already set to identity matrix in kf.init
-
-        // Measure Matrix H
-        kf.measurementMatrix.at<double>(0) = 1.0;
-
         // Process Noise Covariance Matrix Q
-        // 1 0
-        // 0 1
-        kf.processNoiseCov.at<double>(0) = p.positionProcessNoiseCov;
-        kf.processNoiseCov.at<double>(3) = p.velocityProcessNoiseCov;
+        // Ep 0
+        // 0  Ev
+        kf.positionNoise = p.positionProcessNoiseCov;
+        kf.velocityNoise = p.velocityProcessNoiseCov;
 
         // Measures Noise Covariance Matrix R
-        cv::setIdentity(kf.measurementNoiseCov, cv::Scalar::all(p.measurementNoiseCov));
+        kf.measurementNoise = p.measurementNoiseCov;
     }
 
     void update(const double position)
     {
-        meas.at<double>(0) = position;
-
         if (notFoundCountDown <= 0) {
-            state.at<double>(0) = meas.at<double>(0);
-            state.at<double>(1) = 0;
-            kf.statePost = state;
-            setIdentity(kf.errorCovPost);
+            kf.reset(position);
         } else {
-            state = kf.correct(meas);
+            kf.correct(position);
         }
         notFoundCountDown = p.notUpdatedTimeoutInMsec;
     }
@@ -79,15 +54,12 @@ struct KalmanTracker1D::Data {
     {
         notFoundCountDown -= elapsedMsec;
         if (notFoundCountDown > 0) {
-            kf.transitionMatrix.at<double>(1) = elapsedMsec;
-            state = kf.predict();
+            kf.predict(elapsedMsec);
         }
     }
 
     KalmanTracker1D::Params p;
-    cv::KalmanFilter kf;
-    cv::Mat state; // [x,v_x]
-    cv::Mat meas; // [x]
+    KalmanFilter<2, 1> kf; // [x,v_x]
     double notFoundCountDown;
 };
 
@@ -117,12 +89,12 @@ bool KalmanTracker1D::hasPosition() const
 
 double KalmanTracker1D::position() const
 {
-    return _d->state.at<double>(0);
+    return _d->kf.state[0];
 }
 
 double KalmanTracker1D::velocity() const
 {
-    return _d->state.at<double>(1);
+    return _d->kf.state[1];
 }
 
 const KalmanTracker1D::Params& KalmanTracker1D::movingTanksParams()
@@ -15,11 +15,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "KalmanTracker3D.h"
-#include <opencv2/video/tracking.hpp>
-
-const int stateSize = 6;
-const int measSize = 3;
-const int contrSize = 0;
+#include "KalmanFilter.h"
 
 KalmanTracker3D::Params::Params(double positionXYProcessNoiseCov,
     double positionZProcessNoiseCov,
@@ -46,31 +42,10 @@ KalmanTracker3D::Params::Params(double positionXYProcessNoiseCov,
 struct KalmanTracker3D::Data {
     Data(const KalmanTracker3D::Params& p)
         : p(p)
-        , kf(stateSize, measSize, contrSize, CV_64F)
-        , state(stateSize, 1, CV_64F)
-        , meas(measSize, 1, CV_64F)
         , notFoundCountDown(0)
     {
-        // Transition State Matrix A
-        // Note: set dT at each processing step!
-        // [ 1 0 0 dT 0 0 ]
-        // [ 0 1 0 0 dT 0 ]
-        // [ 0 0 1 0 0 dT ]
-        // [ 0 0 0 1 0  0 ]
-        // [ 0 0 0 0 1  0 ]
-        // [ 0 0 0 0 0  1 ]
-        //
-        // is set to identity by kf.init
-
-        // Measure Matrix H
-        // [ 1 0 0 0 0 0 ]
-        // [ 0 1 0 0 0 0 ]
-        // [ 0 0 1 0 0 0 ]
-        kf.measurementMatrix.at<double>(0) = 1.0;
-        kf.measurementMatrix.at<double>(7) = 1.0;
-        kf.measurementMatrix.at<double>(14) = 1.0;
-
-        // Process Noise Covariance Matrix Q
+        // Transition, process noise and measurement noise are all block diagonal per axis,
+        // so the 6 state filter falls apart in one position/velocity filter per axis:
         //       p_x p_y p_z v_x  v_y   v_z
         // p_x [ Ex  0   0   *     0     0    ]
         // p_y [ 0   Ey  0   0     *     0    ]
@@ -78,32 +53,24 @@ struct KalmanTracker3D::Data {
         // v_x [ *   0   0   Ev_x  0     0    ]
         // v_y [ 0   *   0   0     Ev_y  0    ]
         // v_z [ 0   0   *   0     0     Ev_z ]
-        kf.processNoiseCov.at<double>(0) = kf.processNoiseCov.at<double>(7) = p.positionXYProcessNoiseCov;
-        kf.processNoiseCov.at<double>(14) = p.positionZProcessNoiseCov;
-        kf.processNoiseCov.at<double>(21) = kf.processNoiseCov.at<double>(28) = p.velocityXYProcessNoiseCov;
-        kf.processNoiseCov.at<double>(35) = p.velocityZProcessNoiseCov;
-
-        // Measures Noise Covariance Matrix R
-        kf.measurementNoiseCov.at<double>(0) = kf.measurementNoiseCov.at<double>(4) = p.measurementXYNoiseCov;
-        kf.measurementNoiseCov.at<double>(8) = p.measurementZNoiseCov;
+        for (int i = 0; i < 2; ++i) {
+            axes[i].positionNoise = p.positionXYProcessNoiseCov;
+            axes[i].velocityNoise = p.velocityXYProcessNoiseCov;
+            axes[i].measurementNoise = p.measurementXYNoiseCov;
+        }
+        axes[2].positionNoise = p.positionZProcessNoiseCov;
+        axes[2].velocityNoise = p.velocityZProcessNoiseCov;
+        axes[2].measurementNoise = p.measurementZNoiseCov;
     }
 
     void update(const QVector3D& position)
     {
-        meas.at<double>(0) = position.x();
-        meas.at<double>(1) = position.y();
-        meas.at<double>(2) = position.z();
-
-        if (notFoundCountDown <= 0) {
-            state.at<double>(0) = meas.at<double>(0);
-            state.at<double>(1) = meas.at<double>(1);
-            state.at<double>(2) = meas.at<double>(2);
-            state.at<double>(3) = state.at<double>(4) = state.at<double>(5) = 0;
-
-            kf.statePost = state;
-            setIdentity(kf.errorCovPost);
-        } else {
-            state = kf.correct(meas);
+        for (int i = 0; i < 3; ++i) {
+            if (notFoundCountDown <= 0) {
+                axes[i].reset(position[i]);
+            } else {
+                axes[i].correct(position[i]);
+            }
         }
         notFoundCountDown = p.notUpdatedTimeoutInMsec;
     }
@@ -114,19 +81,15 @@ struct KalmanTracker3D::Data {
             notFoundCountDown -= elapsedMsec;
         }
         if (notFoundCountDown > 0) {
-            kf.transitionMatrix.at<double>(3) = elapsedMsec;
-            kf.transitionMatrix.at<double>(10) = elapsedMsec;
-            kf.transitionMatrix.at<double>(17) = elapsedMsec;
-            state = kf.predict();
+            for (auto& axis : axes) {
+                axis.predict(elapsedMsec);
+            }
         }
     }
 
     KalmanTracker3D::Params p;
-    cv::KalmanFilter kf;
-    cv::Mat state; // [x,y,z,v_x,v_y,v_z]
-    cv::Mat meas; // [x,y,z]
+    KalmanFilter<2, 1> axes[3]; // [x,v_x], [y,v_y], [z,v_z]
     double notFoundCountDown;
-    QVector3D rotation;
 };
 
 KalmanTracker3D::KalmanTracker3D(const Params& p)
@@ -155,7 +118,7 @@ bool KalmanTracker3D::hasPosition() const
 
 QVector3D KalmanTracker3D::position() const
 {
-    return QVector3D(_d->state.at<double>(0), _d->state.at<double>(1), _d->state.at<double>(2));
+    return QVector3D(_d->axes[0].state[0], _d->axes[1].state[0], _d->axes[2].state[0]);
 }
 
 const KalmanTracker3D::Params& KalmanTracker3D::movingTanksParams()
@@ -0,0 +1,125 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "OrientationFilter.h"
+#include <QtMath>
+#include <math.h>
+
+OrientationFilter::Params::Params(double angleProcessNoiseCov, double angularVelocityProcessNoiseCov, double measurementNoiseCov, double notUpdatedTimeoutInMsec)
+    : angleProcessNoiseCov(angleProcessNoiseCov)
+    , angularVelocityProcessNoiseCov(angularVelocityProcessNoiseCov)
+    , measurementNoiseCov(measurementNoiseCov)
+    , notUpdatedTimeoutInMsec(notUpdatedTimeoutInMsec)
+{
+}
+
+OrientationFilter::OrientationFilter(const Params& p)
+    : _p(p)
+    , _notFoundCountDown(0)
+{
+    // Transition of the error state, to first order in the rotation over one frame
+    //         dt_x dt_y dt_z dw_x dw_y dw_z
+    // dt_x  [ 1    0    0    dT   0    0  ]
+    // dt_y  [ 0    1    0    0    dT   0  ]
+    // dt_z  [ 0    0    1    0    0    dT ]
+    // dw_x  [ 0    0    0    1    0    0  ]
+    // dw_y  [ 0    0    0    0    1    0  ]
+    // dw_z  [ 0    0    0    0    0    1  ]
+    // the angle error is measured directly
+    for (int i = 0; i < 3; ++i) {
+        _kf.measurement(i, i) = 1.0;
+        _kf.measurementNoise(i, i) = p.measurementNoiseCov;
+        _kf.processNoise(i, i) = p.angleProcessNoiseCov;
+        _kf.processNoise(i + 3, i + 3) = p.angularVelocityProcessNoiseCov;
+    }
+}
+
+void OrientationFilter::update(const QQuaternion& orientation)
+{
+    if (_notFoundCountDown <= 0) {
+        _orientation = orientation.normalized();
+        _angularVelocity = QVector3D();
+        _kf.reset(ErrorFilter::StateVector::all(0));
+    } else {
+        // residual rotation in the body frame, q and -q are the same attitude
+        QQuaternion residual = _orientation.conjugated() * orientation.normalized();
+        if (residual.scalar() < 0) {
+            residual = -residual;
+        }
+        const QVector3D z = toRotationVector(residual);
+        _kf.correct(cv::Vec3d(z.x(), z.y(), z.z()));
+
+        // inject the estimated error and start again from zero error
+        const auto& error = _kf.state;
+        _orientation = (_orientation * fromRotationVector(QVector3D(error[0], error[1], error[2]))).normalized();
+        _angularVelocity += QVector3D(error[3], error[4], error[5]);
+        _kf.state = ErrorFilter::StateVector::all(0);
+    }
+    _notFoundCountDown = _p.notUpdatedTimeoutInMsec;
+}
+
+void OrientationFilter::predict(double elapsedMsec)
+{
+    _notFoundCountDown -= elapsedMsec;
+    if (_notFoundCountDown > 0) {
+        for (int i = 0; i < 3; ++i) {
+            _kf.transition(i, i + 3) = elapsedMsec;
+        }
+        _kf.predict();
+        _orientation = (_orientation * fromRotationVector(_angularVelocity * elapsedMsec)).normalized();
+    }
+}
+
+bool OrientationFilter::hasOrientation() const
+{
+    return _notFoundCountDown > 0;
+}
+
+QQuaternion OrientationFilter::orientation() const
+{
+    return _orientation;
+}
+
+QVector3D OrientationFilter::angularVelocity() const
+{
+    return _angularVelocity;
+}
+
+QQuaternion OrientationFilter::fromRotationVector(const QVector3D& rotation)
+{
+    const float angle = rotation.length();
+    if (angle < 1e-6f) {
+        // first order, avoids dividing by the tiny angle
+        return QQuaternion(1, rotation / 2).normalized();
+    }
+    return QQuaternion::fromAxisAndAngle(rotation / angle, qRadiansToDegrees(angle));
+}
+
+QVector3D OrientationFilter::toRotationVector(const QQuaternion& rotation)
+{
+    const QVector3D axis = rotation.vector();
+    const float sinHalfAngle = axis.length();
+    if (sinHalfAngle < 1e-6f) {
+        return 2 * axis;
+    }
+    return axis * (2 * atan2f(sinHalfAngle, rotation.scalar()) / sinHalfAngle);
+}
+
+const OrientationFilter::Params& OrientationFilter::movingTanksParams()
+{
+    static const Params result(1e-4, 1e-7, 1e-3, 3000);
+    return result;
+}
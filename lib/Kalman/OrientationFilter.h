@@ -0,0 +1,62 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "KalmanFilter.h"
+#include <QQuaternion>
+#include <QVector3D>
+
+// 3D orientation with constant angular velocity, filtered in error-state form: the attitude
+// itself is a quaternion and the Kalman filter only estimates the small rotation and angular
+// velocity error around it, both in the body frame. The error is injected into the quaternion
+// after every correction, so it never wraps or hits a singularity. A plain value, so markers
+// can keep it inline.
+class OrientationFilter {
+public:
+    struct Params {
+        Params(double angleProcessNoiseCov = 1e-4, double angularVelocityProcessNoiseCov = 1e-7, double measurementNoiseCov = 1e-3, double notUpdatedTimeoutInMsec = 3000);
+
+        double angleProcessNoiseCov;
+        double angularVelocityProcessNoiseCov;
+        double measurementNoiseCov;
+        double notUpdatedTimeoutInMsec;
+    };
+
+    OrientationFilter(const Params& p = Params());
+
+    void update(const QQuaternion& orientation);
+    void predict(double elapsedMsec);
+
+    bool hasOrientation() const;
+    QQuaternion orientation() const;
+    // body frame, radians per millisecond
+    QVector3D angularVelocity() const;
+
+    // rotation vector (axis times angle in radians) to quaternion and back
+    static QQuaternion fromRotationVector(const QVector3D& rotation);
+    static QVector3D toRotationVector(const QQuaternion& rotation);
+
+    static const Params& movingTanksParams();
+
+private:
+    using ErrorFilter = KalmanFilter<6, 3>;
+
+    Params _p;
+    ErrorFilter _kf; // [dtheta, domega]
+    QQuaternion _orientation;
+    QVector3D _angularVelocity;
+    double _notFoundCountDown;
+};
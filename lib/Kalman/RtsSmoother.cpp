@@ -0,0 +1,319 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "RtsSmoother.h"
+#include "KalmanFilter.h"
+#include <QTemporaryFile>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+namespace {
+// steps and estimates read back from the temporary files at once
+const int BLOCK_SIZE = 4096;
+
+// state and symmetric error covariance of one [p, v] axis
+struct AxisEstimate {
+    double position;
+    double velocity;
+    double p00;
+    double p01;
+    double p11;
+};
+
+struct Step {
+    int frame;
+    // predicted from the previous step, false when the filter started over
+    bool linked;
+    bool hasPosition;
+    double elapsedMsec;
+    AxisEstimate predicted[3];
+    AxisEstimate filtered[3];
+};
+
+static_assert(std::is_trivially_copyable<Step>::value, "steps are spilled as raw bytes");
+static_assert(std::is_trivially_copyable<RtsSmoother::Estimate>::value, "estimates are spilled as raw bytes");
+
+AxisEstimate toAxisEstimate(const KalmanFilter<2, 1>& filter)
+{
+    const cv::Matx22d p = filter.errorCov();
+    return { filter.state[0], filter.state[1], p(0, 0), p(0, 1), p(1, 1) };
+}
+
+// backward step: x = x_f + C (x_s' - x_p'), P = P_f + C (P_s' - P_p') C^T with C = P_f A^T P_p'^-1
+AxisEstimate smooth(const AxisEstimate& filtered, const AxisEstimate& nextPredicted, const AxisEstimate& nextSmoothed, double dt)
+{
+    // P_f A^T with A = [1 dt; 0 1]
+    const double a00 = filtered.p00 + dt * filtered.p01;
+    const double a01 = filtered.p01;
+    const double a10 = filtered.p01 + dt * filtered.p11;
+    const double a11 = filtered.p11;
+
+    const double det = nextPredicted.p00 * nextPredicted.p11 - nextPredicted.p01 * nextPredicted.p01;
+    const double i00 = nextPredicted.p11 / det;
+    const double i01 = -nextPredicted.p01 / det;
+    const double i11 = nextPredicted.p00 / det;
+
+    const double c00 = a00 * i00 + a01 * i01;
+    const double c01 = a00 * i01 + a01 * i11;
+    const double c10 = a10 * i00 + a11 * i01;
+    const double c11 = a10 * i01 + a11 * i11;
+
+    const double dx0 = nextSmoothed.position - nextPredicted.position;
+    const double dx1 = nextSmoothed.velocity - nextPredicted.velocity;
+    const double d00 = nextSmoothed.p00 - nextPredicted.p00;
+    const double d01 = nextSmoothed.p01 - nextPredicted.p01;
+    const double d11 = nextSmoothed.p11 - nextPredicted.p11;
+
+    const double e00 = c00 * d00 + c01 * d01;
+    const double e01 = c00 * d01 + c01 * d11;
+    const double e10 = c10 * d00 + c11 * d01;
+    const double e11 = c10 * d01 + c11 * d11;
+
+    AxisEstimate result;
+    result.position = filtered.position + c00 * dx0 + c01 * dx1;
+    result.velocity = filtered.velocity + c10 * dx0 + c11 * dx1;
+    result.p00 = filtered.p00 + e00 * c00 + e01 * c01;
+    result.p01 = filtered.p01 + e00 * c10 + e01 * c11;
+    result.p11 = filtered.p11 + e10 * c10 + e11 * c11;
+    return result;
+}
+
+// smooths step with the already smoothed estimate of the step after it
+void smoothStep(const Step& step, const Step* next, AxisEstimate* smoothed)
+{
+    for (int i = 0; i < 3; ++i) {
+        smoothed[i] = next && next->linked
+            ? smooth(step.filtered[i], next->predicted[i], smoothed[i], next->elapsedMsec)
+            : step.filtered[i];
+    }
+}
+
+RtsSmoother::Estimate toEstimate(int frame, const AxisEstimate* axes)
+{
+    return { frame,
+        QVector3D(float(axes[0].position), float(axes[1].position), float(axes[2].position)),
+        QVector3D(float(axes[0].velocity), float(axes[1].velocity), float(axes[2].velocity)) };
+}
+
+template <class T>
+bool readBlock(QFile& file, qint64 first, qint64 count, std::vector<T>& block)
+{
+    block.resize(size_t(count));
+    const qint64 bytes = count * qint64(sizeof(T));
+    return file.seek(first * qint64(sizeof(T)))
+        && file.read(reinterpret_cast<char*>(block.data()), bytes) == bytes;
+}
+
+template <class T>
+bool append(QFile& file, const T& value)
+{
+    return file.write(reinterpret_cast<const char*>(&value), sizeof(T)) == qint64(sizeof(T));
+}
+}
+
+struct RtsSmoother::Data {
+    Data(int lag, const KalmanTracker3D::Params& p)
+        : lag(lag)
+        , p(p)
+        , notFoundCountDown(0)
+        , isValid(true)
+        , isFinished(false)
+        , stepCount(0)
+        , estimateCount(0)
+    {
+        for (int i = 0; i < 2; ++i) {
+            axes[i].positionNoise = p.positionXYProcessNoiseCov;
+            axes[i].velocityNoise = p.velocityXYProcessNoiseCov;
+            axes[i].measurementNoise = p.measurementXYNoiseCov;
+        }
+        axes[2].positionNoise = p.positionZProcessNoiseCov;
+        axes[2].velocityNoise = p.velocityZProcessNoiseCov;
+        axes[2].measurementNoise = p.measurementZNoiseCov;
+
+        if (lag <= 0) {
+            isValid = steps.open() && estimates.open();
+        }
+    }
+
+    // same order as KalmanTracker3D: predict, then update
+    Step forward(int frame, double elapsedMsec, const QVector3D* measurement)
+    {
+        Step step;
+        step.frame = frame;
+        step.elapsedMsec = elapsedMsec;
+        if (p.useTimeout) {
+            notFoundCountDown -= elapsedMsec;
+        }
+        step.linked = notFoundCountDown > 0;
+        for (int i = 0; i < 3; ++i) {
+            if (step.linked) {
+                axes[i].predict(elapsedMsec);
+            }
+            step.predicted[i] = toAxisEstimate(axes[i]);
+        }
+        if (measurement) {
+            for (int i = 0; i < 3; ++i) {
+                if (step.linked) {
+                    axes[i].correct((*measurement)[i]);
+                } else {
+                    axes[i].reset((*measurement)[i]);
+                }
+            }
+            notFoundCountDown = p.notUpdatedTimeoutInMsec;
+        }
+        step.hasPosition = notFoundCountDown > 0;
+        for (int i = 0; i < 3; ++i) {
+            step.filtered[i] = toAxisEstimate(axes[i]);
+        }
+        return step;
+    }
+
+    // smooths the oldest step of the window over the rest of it
+    void finalizeOldest()
+    {
+        AxisEstimate smoothed[3];
+        const Step* next = nullptr;
+        for (auto step = window.rbegin(); step != window.rend(); ++step) {
+            smoothStep(*step, next, smoothed);
+            next = &*step;
+        }
+        if (window.front().hasPosition) {
+            ready.push_back(toEstimate(window.front().frame, smoothed));
+        }
+        window.pop_front();
+    }
+
+    // backward over the spilled steps, newest first, spilling the estimates in that order too
+    void smoothRecording()
+    {
+        std::vector<Step> block;
+        AxisEstimate smoothed[3];
+        Step next;
+        bool hasNext = false;
+        isValid = steps.flush();
+        for (qint64 end = stepCount; end > 0 && isValid;) {
+            const qint64 begin = qMax<qint64>(0, end - BLOCK_SIZE);
+            isValid = readBlock(steps, begin, end - begin, block);
+            for (auto step = block.rbegin(); step != block.rend() && isValid; ++step) {
+                smoothStep(*step, hasNext ? &next : nullptr, smoothed);
+                if (step->hasPosition) {
+                    isValid = append(estimates, toEstimate(step->frame, smoothed));
+                    ++estimateCount;
+                }
+                next = *step;
+                hasNext = true;
+            }
+            end = begin;
+        }
+        steps.resize(0);
+        isValid = isValid && estimates.flush();
+    }
+
+    // reads the spilled estimates back from the end, which is oldest first
+    bool takeSpilled(Estimate& estimate)
+    {
+        if (ready.empty() && estimateCount > 0 && isValid) {
+            const qint64 begin = qMax<qint64>(0, estimateCount - BLOCK_SIZE);
+            std::vector<Estimate> block;
+            isValid = readBlock(estimates, begin, estimateCount - begin, block);
+            ready.assign(block.rbegin(), block.rend());
+            estimateCount = begin;
+        }
+        return takeReady(estimate);
+    }
+
+    bool takeReady(Estimate& estimate)
+    {
+        if (ready.empty()) {
+            return false;
+        }
+        estimate = ready.front();
+        ready.pop_front();
+        return true;
+    }
+
+    const int lag;
+    const KalmanTracker3D::Params p;
+    KalmanFilter<2, 1> axes[3]; // [x,v_x], [y,v_y], [z,v_z]
+    double notFoundCountDown;
+    bool isValid;
+    bool isFinished;
+
+    // fixed lag
+    std::deque<Step> window;
+    std::deque<Estimate> ready;
+
+    // whole recording
+    QTemporaryFile steps;
+    QTemporaryFile estimates;
+    qint64 stepCount;
+    qint64 estimateCount;
+};
+
+RtsSmoother::RtsSmoother(int lag, const KalmanTracker3D::Params& p)
+    : _d(new Data(lag, p))
+{
+}
+
+RtsSmoother::~RtsSmoother()
+{
+}
+
+void RtsSmoother::step(int frame, double elapsedMsec, const QVector3D* measurement)
+{
+    if (_d->isFinished) {
+        return;
+    }
+    const Step step = _d->forward(frame, elapsedMsec, measurement);
+    if (_d->lag > 0) {
+        _d->window.push_back(step);
+        if (int(_d->window.size()) > _d->lag) {
+            _d->finalizeOldest();
+        }
+    } else if (_d->isValid) {
+        _d->isValid = append(_d->steps, step);
+        ++_d->stepCount;
+    }
+}
+
+void RtsSmoother::finish()
+{
+    if (_d->isFinished) {
+        return;
+    }
+    _d->isFinished = true;
+    if (_d->lag > 0) {
+        while (!_d->window.empty()) {
+            _d->finalizeOldest();
+        }
+    } else if (_d->isValid) {
+        _d->smoothRecording();
+    }
+}
+
+bool RtsSmoother::takeEstimate(Estimate& estimate)
+{
+    if (_d->lag > 0) {
+        return _d->takeReady(estimate);
+    }
+    return _d->isFinished && _d->takeSpilled(estimate);
+}
+
+bool RtsSmoother::isValid() const
+{
+    return _d->isValid;
+}
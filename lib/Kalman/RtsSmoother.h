@@ -0,0 +1,52 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "KalmanTracker3D.h"
+#include <QScopedPointer>
+#include <QVector3D>
+
+// Rauch-Tung-Striebel smoother on the constant velocity model of KalmanTracker3D.
+// Every step runs the forward filter of the tracker, the backward pass then corrects each
+// estimate with the measurements that came after it.
+// With a lag the backward pass spans the lag newest steps and an estimate is final lag steps
+// after it was filtered. Without a lag it spans the whole recording: the forward pass spills to
+// a temporary file that is read back in blocks, so memory does not grow with the recording.
+class RtsSmoother {
+public:
+    struct Estimate {
+        int frame;
+        QVector3D position;
+        QVector3D velocity; // per msec
+    };
+
+    explicit RtsSmoother(int lag = 0, const KalmanTracker3D::Params& p = KalmanTracker3D::movingTanksParams());
+    ~RtsSmoother();
+
+    // predicts elapsedMsec ahead, then corrects with the measurement when there is one
+    void step(int frame, double elapsedMsec, const QVector3D* measurement);
+    // no more steps follow, all remaining estimates become final
+    void finish();
+    // final estimates, oldest first; steps where the tracker lost the marker have none
+    bool takeEstimate(Estimate& estimate);
+
+    // false once the temporary files failed
+    bool isValid() const;
+
+private:
+    struct Data;
+    QScopedPointer<Data> _d;
+};
@@ -15,7 +15,9 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "ImageSaver.h"
+#include "Video/Video.h"
 #include <QDir>
+#include <QFileInfo>
 #include <QtConcurrent/QtConcurrentRun>
 
 namespace {
@@ -47,28 +49,39 @@ void ImageSaver::setEnabled(bool enabled)
     }
 }
 
-void ImageSaver::saveImage(QImage img)
+void ImageSaver::saveImage(QImage img, qint64 timestampUsecs)
 {
-    saveImageImpl(img, false);
+    saveImageImpl(img, false, timestampUsecs);
 }
 
 void ImageSaver::saveSingleImage(QImage img)
 {
     findFirstAvailableFileCounter();
-    saveImageImpl(img, true);
+    saveImageImpl(img, true, -1);
 }
 
-void ImageSaver::saveImageImpl(QImage img, bool saveSingleFile)
+void ImageSaver::saveImageImpl(QImage img, bool saveSingleFile, qint64 timestampUsecs)
 {
     if ((_enabled || saveSingleFile) && QDir(_path).mkpath(QString("."))) {
         QString filename = generateFilename();
         _fileCounter++;
+        if (timestampUsecs >= 0) {
+            appendTimestamp(filename, timestampUsecs);
+        }
         QtConcurrent::run([=]() -> void {
             img.save(filename, "JPG", 100);
         });
     }
 }
 
+void ImageSaver::appendTimestamp(QString filename, qint64 timestampUsecs)
+{
+    QFile file(QDir(_path).absoluteFilePath(Video::timestampsFileName()));
+    if (file.open(QIODevice::Append | QIODevice::Text)) {
+        file.write(QStringLiteral("%1 %2\n").arg(QFileInfo(filename).fileName()).arg(timestampUsecs).toLatin1());
+    }
+}
+
 QString ImageSaver::generateFilename()
 {
     return QDir(_path).absoluteFilePath(format.arg(_fileCounter, 8, 10, QChar('0')));
@@ -28,13 +28,15 @@ public:
     void setEnabled(bool enabled);
 
 public slots:
-    void saveImage(QImage img);
+    // a known capture timestamp is added to the timestamps file of the recording
+    void saveImage(QImage img, qint64 timestampUsecs = -1);
     void saveSingleImage(QImage img);
 
 private:
     QString generateFilename();
     void findFirstAvailableFileCounter();
-    void saveImageImpl(QImage img, bool saveSingleFile);
+    void saveImageImpl(QImage img, bool saveSingleFile, qint64 timestampUsecs);
+    void appendTimestamp(QString filename, qint64 timestampUsecs);
 
 private:
     QString _path;
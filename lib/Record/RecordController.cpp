@@ -79,12 +79,12 @@ void RecordController::setSkipSavingFrames(int skipSavingFrames)
     emit skipSavingFramesChanged(_skipSavingFrames);
 }
 
-void RecordController::setImage(QImage image)
+void RecordController::setImage(QImage image, qint64 timestampUsecs)
 {
     _image = image;
     if (_saveallframesEnabled && !_image.isNull()) {
         if (_skipSavingFramesCounter == 0) {
-            _saver.saveImage(_image);
+            _saver.saveImage(_image, timestampUsecs);
 
             _skipSavingFramesCounter = _skipSavingFrames;
         } else {
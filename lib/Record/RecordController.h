@@ -36,7 +36,7 @@ public:
     Q_INVOKABLE void saveSingleFrame();
 
 public slots:
-    void setImage(QImage image);
+    void setImage(QImage image, qint64 timestampUsecs = -1);
     void setSavePath(QString savePath);
     void setSaveallframesEnabled(bool saveallframesEnabled);
     void setSkipSavingFrames(int skipSavingFrames);
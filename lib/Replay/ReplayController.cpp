@@ -15,35 +15,55 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "ReplayController.h"
+#include "Aruco/Aruco.h"
+#include "Kalman/RtsSmoother.h"
 #include "Video/Frame.h"
 #include "Video/Video.h"
 #include <QDir>
+#include <QFile>
+#include <QSharedPointer>
 #include <QSettings>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace {
 const int PREFETCH_FRAME_COUNT = 50;
 const QString LOADPATH_KEY(QStringLiteral("LoadPath"));
 const QString REPLAYFPS_KEY(QStringLiteral("ReplayFps"));
+// larger gaps between capture timestamps are taken as a restarted recording
+const qint64 MAX_FRAME_GAP_USECS = 1000000;
 }
 
 ReplayController::ReplayController(QObject* parent)
     : QObject(parent)
+    , _aruco(nullptr)
     , _video(new Video(this))
     , _canReplayStream(false)
     , _isReplayStreaming(false)
     , _frameIndex(-1)
+    , _isSmoothing(false)
+    , _cancelSmoothing(false)
 {
     QSettings settings;
     setLoadPath(settings.value(LOADPATH_KEY, QDir::homePath()).toString());
     setReplayFps(settings.value(REPLAYFPS_KEY, QStringLiteral("10")).toString());
 
     QObject::connect(&_replayTimer, &ReplayTimer::playFrame, this, &ReplayController::setFrameIndex);
+    QObject::connect(&_smoothingWatcher, &QFutureWatcher<bool>::finished, this, [this]() {
+        setIsSmoothing(false);
+        emit smoothingFinished(_smoothingWatcher.result());
+    });
 
     setFrameIndex(-1);
 }
 
 ReplayController::~ReplayController()
 {
+    _cancelSmoothing = true;
+    _smoothingWatcher.waitForFinished();
 }
 
 void ReplayController::setFrameIndex(int index)
@@ -58,6 +78,7 @@ void ReplayController::setFrameIndex(int index)
         _image = frame ? frame->image() : QImage();
         emit frameIndexChanged(_frameIndex);
         emit imageChanged(_image);
+        emit framePlayed(_image, frame ? frame->timestampUsecs() : -1);
 
         while (!_indicesToPrefetch.isEmpty() && (index = _indicesToPrefetch.last()) < _frameIndex + PREFETCH_FRAME_COUNT) {
             _video->frames().at(index)->loadImageFromDisk();
@@ -171,3 +192,132 @@ int ReplayController::frameIndex() const
 {
     return _frameIndex;
 }
+
+Aruco* ReplayController::aruco() const
+{
+    return _aruco;
+}
+
+void ReplayController::setAruco(Aruco* aruco)
+{
+    _aruco = aruco;
+}
+
+bool ReplayController::isSmoothing() const
+{
+    return _isSmoothing;
+}
+
+void ReplayController::setIsSmoothing(bool isSmoothing)
+{
+    if (_isSmoothing == isSmoothing)
+        return;
+
+    _isSmoothing = isSmoothing;
+    emit isSmoothingChanged(_isSmoothing);
+}
+
+bool ReplayController::saveSmoothedTrajectories(QString fileName, int lagFrames)
+{
+    if (!_aruco || _isSmoothing) {
+        return false;
+    }
+    // the tracker keeps detecting with _aruco meanwhile, the pass gets a detector of its own
+    QSharedPointer<Aruco> aruco(new Aruco());
+    aruco->copySettings(*_aruco);
+
+    QVector<SmoothingFrame> frames;
+    frames.reserve(_video->frames().size());
+    for (Frame* frame : _video->frames()) {
+        const QString filePath = frame->filePath();
+        frames.push_back({ filePath, filePath.isEmpty() ? frame->image() : QImage(), frame->timestampUsecs() });
+    }
+    const double msecsPerFrame = 1000.0 / qMax(1, _replayFps.toInt());
+
+    _cancelSmoothing = false;
+    setIsSmoothing(true);
+    _smoothingWatcher.setFuture(QtConcurrent::run([this, aruco, frames, msecsPerFrame, fileName, lagFrames]() -> bool {
+        return smoothTrajectories(*aruco, frames, msecsPerFrame, fileName, lagFrames);
+    }));
+    return true;
+}
+
+bool ReplayController::smoothTrajectories(Aruco& aruco, const QVector<SmoothingFrame>& frames,
+    double msecsPerFrame, const QString& fileName, int lagFrames)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out << "id,frame,timestamp_us,x,y,z,vx,vy,vz\n";
+
+    const std::vector<Aruco::RefineMethod> refineMethods(Aruco::Markers::CAPACITY, Aruco::FullRefinement);
+    std::map<int, std::unique_ptr<RtsSmoother>> smoothers;
+    bool isValid = true;
+
+    auto writeEstimates = [&](int id, RtsSmoother& smoother) {
+        RtsSmoother::Estimate e;
+        while (smoother.takeEstimate(e)) {
+            out << id << ',' << e.frame << ',' << frames.at(e.frame).timestampUsecs
+                << ',' << e.position.x() << ',' << e.position.y() << ',' << e.position.z()
+                << ',' << e.velocity.x() << ',' << e.velocity.y() << ',' << e.velocity.z() << '\n';
+        }
+        isValid = isValid && smoother.isValid();
+    };
+
+    qint64 lastTimestampUsecs = -1;
+    int lastPercent = -1;
+    for (int index = 0; index < frames.size() && isValid; ++index) {
+        if (_cancelSmoothing) {
+            return false;
+        }
+        const SmoothingFrame& frame = frames.at(index);
+        const qint64 timestampUsecs = frame.timestampUsecs;
+        const qint64 gapUsecs = timestampUsecs - lastTimestampUsecs;
+        const bool validGap = timestampUsecs >= 0 && lastTimestampUsecs >= 0 && gapUsecs > 0 && gapUsecs <= MAX_FRAME_GAP_USECS;
+        const double elapsedMsec = validGap ? gapUsecs / 1000.0 : msecsPerFrame;
+        lastTimestampUsecs = timestampUsecs;
+
+        // offline there is time for the full refinement of every marker
+        const QImage image = frame.filePath.isEmpty()
+            ? frame.image
+            : QImage(frame.filePath).convertToFormat(QImage::Format_RGB888);
+        auto markers = aruco.detectMarkers(image);
+        aruco.refineCorners(image, markers, refineMethods.data());
+        aruco.estimatePoses(markers);
+
+        for (int i = 0; i < markers.count; ++i) {
+            auto& smoother = smoothers[markers.ids[i]];
+            if (!smoother) {
+                smoother.reset(new RtsSmoother(lagFrames));
+            }
+        }
+        for (auto& entry : smoothers) {
+            QVector3D position;
+            const QVector3D* measurement = nullptr;
+            for (int i = 0; i < markers.count; ++i) {
+                if (markers.ids[i] == entry.first) {
+                    const cv::Vec3d& tvec = markers.tvecs[i];
+                    position = QVector3D(tvec[0], tvec[1], tvec[2]);
+                    measurement = &position;
+                }
+            }
+            entry.second->step(index, elapsedMsec, measurement);
+            writeEstimates(entry.first, *entry.second);
+        }
+
+        const int percent = 100 * (index + 1) / frames.size();
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit smoothingProgress(index + 1, frames.size());
+        }
+    }
+    // over the whole recording the estimates only come now, one marker after the other
+    for (auto& entry : smoothers) {
+        entry.second->finish();
+        writeEstimates(entry.first, *entry.second);
+    }
+    out.flush();
+    return isValid && out.status() == QTextStream::Ok;
+}
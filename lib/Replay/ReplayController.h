@@ -16,8 +16,11 @@
 */
 #pragma once
 #include "ReplayTimer.h"
+#include <Aruco/Aruco.h>
+#include <QFutureWatcher>
 #include <QImage>
 #include <QObject>
+#include <atomic>
 
 class Video;
 
@@ -30,6 +33,8 @@ class ReplayController : public QObject {
     Q_PROPERTY(bool isReplayStreaming READ isReplayStreaming NOTIFY isReplayStreamingChanged)
     Q_PROPERTY(int frameIndex READ frameIndex NOTIFY frameIndexChanged)
     Q_PROPERTY(QImage image READ image NOTIFY imageChanged)
+    Q_PROPERTY(Aruco* aruco READ aruco WRITE setAruco)
+    Q_PROPERTY(bool isSmoothing READ isSmoothing NOTIFY isSmoothingChanged)
 
 public:
     explicit ReplayController(QObject* parent = nullptr);
@@ -45,24 +50,50 @@ public:
     QImage image() const;
     int frameIndex() const;
 
+    Aruco* aruco() const;
+    void setAruco(Aruco* aruco);
+
+    // detects the markers in every frame of the recording and writes their smoothed trajectories
+    // as csv; lagFrames > 0 smooths with a fixed lag, 0 over the whole recording.
+    // Runs in the background with its own copy of the aruco settings, false when one already runs.
+    Q_INVOKABLE bool saveSmoothedTrajectories(QString fileName, int lagFrames = 0);
+    bool isSmoothing() const;
+
 public slots:
     void setLoadPath(QString loadPath);
     void setReplayFps(QString replayFps);
 
 signals:
     void imageChanged(QImage image);
+    // with the capture timestamp of a recording, -1 when it has none
+    void framePlayed(QImage image, qint64 timestampUsecs);
     void frameIndexChanged(int index);
     void loadPathChanged(QString loadPath);
     void replayFpsChanged(QString replayFps);
     void canReplayStreamChanged(bool canReplayStream);
     void isReplayStreamingChanged(bool isReplayStreaming);
+    void isSmoothingChanged(bool isSmoothing);
+    // emitted from the smoothing thread
+    void smoothingProgress(int frames, int frameCount);
+    void smoothingFinished(bool ok);
 
 private:
     void setFrameIndex(int index);
     void setCanReplayStream(bool canReplayStream);
     void setIsReplayStreaming(bool isReplayStreaming);
+    void setIsSmoothing(bool isSmoothing);
+
+    // what the smoothing thread needs of a frame, taken on the gui thread
+    struct SmoothingFrame {
+        QString filePath;
+        QImage image;
+        qint64 timestampUsecs;
+    };
+    bool smoothTrajectories(Aruco& aruco, const QVector<SmoothingFrame>& frames,
+        double msecsPerFrame, const QString& fileName, int lagFrames);
 
 private:
+    Aruco* _aruco;
     Video* _video;
     QImage _image;
     QString _loadPath;
@@ -72,4 +103,7 @@ private:
     bool _isReplayStreaming;
     int _frameIndex;
     QVector<int> _indicesToPrefetch;
+    bool _isSmoothing;
+    std::atomic<bool> _cancelSmoothing;
+    QFutureWatcher<bool> _smoothingWatcher;
 };
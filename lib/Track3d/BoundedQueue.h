@@ -0,0 +1,84 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <deque>
+#include <utility>
+
+// First in, first out hand-off between two threads. push blocks while the queue is full, so a
+// fast producer is held back by a slow consumer instead of piling up items.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(int capacity)
+        : _capacity(size_t(capacity))
+        , _closed(false)
+    {
+    }
+
+    // false when the queue was closed, the item is dropped then
+    bool push(T item)
+    {
+        QMutexLocker lock(&_mutex);
+        while (!_closed && _items.size() >= _capacity) {
+            _notFull.wait(&_mutex);
+        }
+        if (_closed)
+            return false;
+
+        _items.push_back(std::move(item));
+        _notEmpty.wakeOne();
+        return true;
+    }
+
+    // false when the queue was closed
+    bool pop(T& item)
+    {
+        QMutexLocker lock(&_mutex);
+        while (!_closed && _items.empty()) {
+            _notEmpty.wait(&_mutex);
+        }
+        if (_closed)
+            return false;
+
+        item = std::move(_items.front());
+        _items.pop_front();
+        _notFull.wakeOne();
+        return true;
+    }
+
+    // drops the queued items and releases every waiting thread
+    void close()
+    {
+        QMutexLocker lock(&_mutex);
+        _closed = true;
+        _items.clear();
+        _notEmpty.wakeAll();
+        _notFull.wakeAll();
+    }
+
+private:
+    const size_t _capacity;
+    bool _closed;
+    std::deque<T> _items;
+    QMutex _mutex;
+    QWaitCondition _notEmpty;
+    QWaitCondition _notFull;
+};
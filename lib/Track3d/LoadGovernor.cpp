@@ -0,0 +1,103 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LoadGovernor.h"
+
+namespace {
+const float SMOOTHING = 0.1f;
+const float REDUCED_SCALE = 0.5f;
+}
+
+LoadGovernor::LoadGovernor(int maxLevel, float headroom, int holdFrames)
+    : _maxLevel(maxLevel)
+    , _headroom(headroom)
+    , _holdFrames(holdFrames)
+    , _budget(33.3f)
+    , _averageMsecs(0)
+    , _detectionMsecs(0)
+    , _level(0)
+    , _framesAtLevel(0)
+{
+}
+
+float LoadGovernor::budget() const
+{
+    return _budget;
+}
+
+void LoadGovernor::setBudget(float msecs)
+{
+    _budget = msecs;
+}
+
+int LoadGovernor::level() const
+{
+    return _level;
+}
+
+double LoadGovernor::detectionScale() const
+{
+    return _level > 0 ? REDUCED_SCALE : 1.0;
+}
+
+int LoadGovernor::detectionInterval() const
+{
+    return _level > 1 ? _level : 1;
+}
+
+bool LoadGovernor::addFrameTime(float msecs, bool detected)
+{
+    _averageMsecs += SMOOTHING * (msecs - _averageMsecs);
+    if (detected) {
+        _detectionMsecs += SMOOTHING * (msecs - _detectionMsecs);
+    }
+    _framesAtLevel++;
+
+    // give the average time to settle on the new level before deciding again
+    if (_framesAtLevel < _holdFrames)
+        return false;
+
+    // skipped frames are almost free, so one level down costs about one detection per lower interval;
+    // detection time grows with the pixel count, back at full resolution a frame costs about 1 / scale²
+    const int lowerInterval = _level > 2 ? _level - 1 : 1;
+    float lowerLevelMsecs = _averageMsecs;
+    if (_level > 1) {
+        lowerLevelMsecs = _detectionMsecs / lowerInterval;
+    } else if (_level == 1) {
+        lowerLevelMsecs = _averageMsecs / (REDUCED_SCALE * REDUCED_SCALE);
+    }
+
+    int level = _level;
+    if (_averageMsecs > _budget && _level < _maxLevel) {
+        level++;
+    } else if (lowerLevelMsecs < _headroom * _budget && _level > 0) {
+        level--;
+    }
+    if (level == _level)
+        return false;
+
+    _level = level;
+    _framesAtLevel = 0;
+    return true;
+}
+
+void LoadGovernor::reset()
+{
+    _averageMsecs = 0;
+    _detectionMsecs = 0;
+    _level = 0;
+    _framesAtLevel = 0;
+}
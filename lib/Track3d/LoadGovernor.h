@@ -0,0 +1,47 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+// Chooses a quality level from the measured processing time per frame:
+// level 0 is full quality, level 1 detects on a half resolution image and
+// every level above detects only on every level-th frame.
+class LoadGovernor
+{
+public:
+    explicit LoadGovernor(int maxLevel = 4, float headroom = 0.6f, int holdFrames = 30);
+
+    float budget() const;
+    void setBudget(float msecs);
+
+    int level() const;
+    double detectionScale() const;
+    int detectionInterval() const;
+
+    // returns true when the level changed
+    bool addFrameTime(float msecs, bool detected);
+    void reset();
+
+private:
+    const int _maxLevel;
+    const float _headroom;
+    const int _holdFrames;
+    float _budget;
+    float _averageMsecs;
+    float _detectionMsecs;
+    int _level;
+    int _framesAtLevel;
+};
@@ -15,36 +15,75 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "Marker.h"
+#include "Kalman/KalmanFilterBank.h"
+#include <math.h>
 
-Marker::Marker(int id)
+namespace {
+float heading(const QQuaternion& rotation)
+{
+    const QVector3D xAxis = rotation.rotatedVector(QVector3D(1, 0, 0));
+    return atan2f(xAxis.y(), xAxis.x());
+}
+}
+
+Marker::Marker(int id, KalmanFilterBank* filters, int track)
     : _id(id)
-    , _posFilter(KalmanTracker3D::movingTanksParams())
-    , _angleFilter(KalmanTracker1D::movingTanksParams())
+    , _filters(filters)
+    , _track(track)
+    , _isDetected(false)
+    , _hasMeasurement(false)
+    , _msecsSinceMeasured(0)
+    , _orientationFilter(OrientationFilter::movingTanksParams())
 {
 }
 
-void Marker::setPositionRotation(const QVector3D& newPos, float newAngle, float elapsedMsecs)
+int Marker::id() const
 {
-    _pos = newPos;
-    _posFilter.predict(elapsedMsecs);
-    _posFilter.update(newPos);
+    return _id;
+}
 
-    _angleFilter.predict(elapsedMsecs);
-    _rotationCounter.updateAngle(newAngle);
-    _angle = _rotationCounter.angleWithRotations();
-    _angleFilter.update(_rotationCounter.angleWithRotations());
+int Marker::track() const
+{
+    return _track;
+}
 
-    _isDetected = true;
+void Marker::setTrack(int track)
+{
+    _track = track;
 }
 
-void Marker::setNotDetected(float elapsedMsecs)
+void Marker::setPositionRotation(const QVector3D& newPos, const QQuaternion& newRotation)
 {
-    _posFilter.predict(elapsedMsecs);
-    _angleFilter.predict(elapsedMsecs);
+    _pos = newPos;
+    _rotation = newRotation;
+    _filters->setMeasurement(_track, _pos);
+    _hasMeasurement = true;
+
+    _isDetected = true;
+}
 
+void Marker::setNotDetected()
+{
     _isDetected = false;
 }
 
+void Marker::step(double elapsedMsec)
+{
+    _orientationFilter.predict(elapsedMsec);
+    if (_hasMeasurement) {
+        _orientationFilter.update(_rotation);
+        _hasMeasurement = false;
+        _msecsSinceMeasured = 0;
+    } else {
+        _msecsSinceMeasured += elapsedMsec;
+    }
+}
+
+double Marker::msecsSinceMeasured() const
+{
+    return _msecsSinceMeasured;
+}
+
 bool Marker::isDetected() const
 {
     return _isDetected;
@@ -55,22 +94,47 @@ QVector3D Marker::pos() const
     return _pos;
 }
 
+QQuaternion Marker::rotation() const
+{
+    return _rotation;
+}
+
 float Marker::angle() const
 {
-    return _angle;
+    return heading(_rotation);
 }
 
 bool Marker::isDetectedFiltered() const
 {
-    return _posFilter.hasPosition() && _angleFilter.hasPosition();
+    return _filters->hasPosition(_track) && _orientationFilter.hasOrientation();
 }
 
 QVector3D Marker::filteredPos() const
 {
-    return _posFilter.position();
+    return _filters->position(_track);
+}
+
+QVector3D Marker::filteredVelocity() const
+{
+    return _filters->velocity(_track);
+}
+
+QQuaternion Marker::filteredRotation() const
+{
+    return _orientationFilter.orientation();
+}
+
+QVector3D Marker::angularVelocity() const
+{
+    return _orientationFilter.angularVelocity();
 }
 
 float Marker::filteredAngle() const
 {
-    return _angleFilter.position();
+    return heading(_orientationFilter.orientation());
+}
+
+MarkerState Marker::state() const
+{
+    return { _id, _isDetected, _pos, _rotation, angle(), isDetectedFiltered(), filteredPos(), filteredRotation(), angularVelocity(), filteredAngle() };
 }
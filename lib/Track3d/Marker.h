@@ -15,33 +15,71 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #pragma once
-#include "Kalman/KalmanTracker1D.h"
-#include "Kalman/KalmanTracker3D.h"
-#include "Kalman/RotationCounter.h"
+#include "Kalman/OrientationFilter.h"
+#include <QQuaternion>
 #include <QVector3D>
 
+class KalmanFilterBank;
+
+// copy of a marker for other threads
+struct MarkerState {
+    int id;
+    bool isDetected;
+    QVector3D pos;
+    QQuaternion rotation;
+    float angle;
+    bool isDetectedFiltered;
+    QVector3D filteredPos;
+    QQuaternion filteredRotation;
+    QVector3D angularVelocity;
+    float filteredAngle;
+};
+
+// The last detection of a marker and its filtered pose. The position lives in a track of the
+// shared filter bank that is stepped once per frame for all markers, the orientation filter is
+// stepped along with it.
+// Markers are moved around when the table they live in removes one, so they are assignable.
 class Marker
 {
 public:
-    explicit Marker(int id);
+    Marker(int id, KalmanFilterBank* filters, int track);
 
-    void setPositionRotation(const QVector3D& newPos, float newAngle, float elapsedMsecs);
-    void setNotDetected(float elapsedMsecs);
+    int id() const;
+    int track() const;
+    void setTrack(int track);
+
+    // measurement for the next step, rotation from marker to camera coordinates
+    void setPositionRotation(const QVector3D& newPos, const QQuaternion& newRotation);
+    void setNotDetected();
+    // steps the orientation filter and the time since the last measurement
+    void step(double elapsedMsec);
+    double msecsSinceMeasured() const;
 
     bool isDetected() const;
     QVector3D pos() const;
+    QQuaternion rotation() const;
+    // direction of the marker x axis in the camera xy plane, for display
     float angle() const;
 
     bool isDetectedFiltered() const;
     QVector3D filteredPos() const;
+    // per millisecond
+    QVector3D filteredVelocity() const;
+    QQuaternion filteredRotation() const;
+    // marker frame, radians per millisecond
+    QVector3D angularVelocity() const;
     float filteredAngle() const;
 
+    MarkerState state() const;
+
 private:
-    const int _id;
+    int _id;
+    KalmanFilterBank* _filters;
+    int _track;
     bool _isDetected;
+    bool _hasMeasurement;
+    double _msecsSinceMeasured;
     QVector3D _pos;
-    float _angle;
-    KalmanTracker3D _posFilter;
-    RotationCounter _rotationCounter;
-    KalmanTracker1D _angleFilter;
+    QQuaternion _rotation;
+    OrientationFilter _orientationFilter;
 };
@@ -0,0 +1,101 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MarkerTable.h"
+#include "Kalman/KalmanFilterBank.h"
+#include <algorithm>
+
+MarkerTable::MarkerTable(KalmanFilterBank* filters)
+    : _filters(filters)
+{
+}
+
+int MarkerTable::size() const
+{
+    return int(_markers.size());
+}
+
+Marker& MarkerTable::at(int index)
+{
+    return _markers[index];
+}
+
+const Marker& MarkerTable::at(int index) const
+{
+    return _markers[index];
+}
+
+Marker* MarkerTable::find(int id)
+{
+    if (id < 0 || id >= int(_indexOfId.size()) || _indexOfId[id] < 0)
+        return nullptr;
+
+    return &_markers[_indexOfId[id]];
+}
+
+Marker* MarkerTable::markerFor(int id)
+{
+    if (id < 0)
+        return nullptr;
+
+    if (id >= int(_indexOfId.size())) {
+        _indexOfId.resize(id + 1, -1);
+        const size_t words = id / WORD_BITS + 1;
+        if (words > _known.size()) {
+            _known.resize(words, 0);
+            _found.resize(words, 0);
+        }
+    }
+    int& index = _indexOfId[id];
+    if (index < 0) {
+        index = size();
+        const int track = _filters->add();
+        Q_ASSERT(track == index);
+        _markers.emplace_back(id, _filters, track);
+        _known[id / WORD_BITS] |= uint64_t(1) << (id % WORD_BITS);
+    }
+    return &_markers[index];
+}
+
+void MarkerTable::remove(int id)
+{
+    if (id < 0 || id >= int(_indexOfId.size()) || _indexOfId[id] < 0)
+        return;
+
+    const int index = _indexOfId[id];
+    _filters->remove(index);
+    if (index != size() - 1) {
+        _markers[index] = std::move(_markers.back());
+        _markers[index].setTrack(index);
+        _indexOfId[_markers[index].id()] = index;
+    }
+    _markers.pop_back();
+    _indexOfId[id] = -1;
+    _known[id / WORD_BITS] &= ~(uint64_t(1) << (id % WORD_BITS));
+    _found[id / WORD_BITS] &= ~(uint64_t(1) << (id % WORD_BITS));
+}
+
+void MarkerTable::clearFound()
+{
+    std::fill(_found.begin(), _found.end(), 0);
+}
+
+void MarkerTable::setFound(int id)
+{
+    if (id >= 0 && id < int(_indexOfId.size())) {
+        _found[id / WORD_BITS] |= uint64_t(1) << (id % WORD_BITS);
+    }
+}
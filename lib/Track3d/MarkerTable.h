@@ -0,0 +1,70 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "Marker.h"
+#include <QtGlobal>
+#include <cstdint>
+#include <vector>
+
+class KalmanFilterBank;
+
+// The markers by id: a slot per id up to the highest id seen, the markers themselves stored
+// contiguously, and bitsets of the ids found in the current frame. A marker at index i owns
+// track i of the filter bank; removing one moves the last marker and track into its place, so
+// both stay as dense as the markers that are alive.
+// Marker pointers stay valid until the next marker is added or removed.
+class MarkerTable {
+public:
+    explicit MarkerTable(KalmanFilterBank* filters);
+
+    int size() const;
+    Marker& at(int index);
+    const Marker& at(int index) const;
+
+    // nullptr for an unknown id
+    Marker* find(int id);
+    // adds a marker on first sight, nullptr for a negative id
+    Marker* markerFor(int id);
+    // frees the marker and its track, the id starts over on its next sight
+    void remove(int id);
+
+    void clearFound();
+    void setFound(int id);
+    // calls f(Marker&) for every known marker that was not found since clearFound
+    template <typename F>
+    void forEachMissing(F f);
+
+private:
+    static const int WORD_BITS = 64;
+
+    KalmanFilterBank* const _filters;
+    std::vector<int> _indexOfId;
+    std::vector<Marker> _markers;
+    std::vector<uint64_t> _known;
+    std::vector<uint64_t> _found;
+};
+
+template <typename F>
+void MarkerTable::forEachMissing(F f)
+{
+    for (size_t word = 0; word < _known.size(); ++word) {
+        for (uint64_t missing = _known[word] & ~_found[word]; missing != 0; missing &= missing - 1) {
+            const int id = int(word) * WORD_BITS + int(qCountTrailingZeroBits(missing));
+            f(_markers[_indexOfId[id]]);
+        }
+    }
+}
@@ -17,88 +17,497 @@
 #include "ObjectTracker.h"
 #include "Marker.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QImage>
 #include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+const int QUEUE_CAPACITY = 2;
+// longer gaps are a paused or restarted stream, the filters must not extrapolate over them
+const qint64 MAX_FRAME_GAP_USECS = 1000000;
+// detection restricted to the depth of the tracked markers misses new markers at other depths
+const int FULL_SEARCH_INTERVAL = 15;
+const double DEPTH_MARGIN = 0.3;
+// ids that can be queried with poseAt
+const int POSE_TABLE_SIZE = 1024;
+// spurious ids are forgotten well after the filters gave up on them
+const int MARKER_TIMEOUT_MSECS = int(2 * KalmanTracker3D::movingTanksParams().notUpdatedTimeoutInMsec);
+
+QQuaternion toQuaternion(const cv::Vec3d& rvec)
+{
+    return OrientationFilter::fromRotationVector(QVector3D(rvec[0], rvec[1], rvec[2]));
+}
+}
+
+ObjectTracker::Snapshot::Snapshot()
+    : version(0)
+{
+}
 
 ObjectTracker::ObjectTracker(Aruco* aruco, QObject* parent)
     : QObject(parent)
     , _aruco(aruco)
     , _framesPerSecond(30)
+    , _detectionInterval(1)
+    , _maxFlowError(20.0f)
+    , _skipStaticFrames(false)
+    , _adaptiveQuality(false)
+    , _qualityLevel(0)
+    , _markerTimeout(MARKER_TIMEOUT_MSECS)
+    , _nearestDepth(0)
+    , _farthestDepth(0)
+    , _capturedFrames(QUEUE_CAPACITY)
+    , _detectedFrames(QUEUE_CAPACITY)
+    , _posedFrames(QUEUE_CAPACITY)
+    , _poseStageUsecs(0)
+    , _filterStageUsecs(0)
+    , _lastTimestampUsecs(-1)
+    , _framesSinceDetection(0)
+    , _framesSinceProcessed(0)
+    , _framesSinceFullSearch(0)
+    , _markerTable(&_filters)
+    , _version(0)
+    , _poses(new SeqLock<PublishedPose>[POSE_TABLE_SIZE])
 {
+    if (_aruco) {
+        _stageThreads << QThread::create([this] { detectionStage(); })
+                      << QThread::create([this] { poseStage(); })
+                      << QThread::create([this] { filterStage(); });
+        for (auto thread : qAsConst(_stageThreads)) {
+            thread->start(QThread::TimeCriticalPriority);
+        }
+    }
 }
 
 ObjectTracker::~ObjectTracker()
 {
-    qDeleteAll(_idToMarker.values());
+    _capturedFrames.close();
+    _detectedFrames.close();
+    _posedFrames.close();
+    for (auto thread : qAsConst(_stageThreads)) {
+        thread->wait();
+    }
+    qDeleteAll(_stageThreads);
 }
 
-void ObjectTracker::processFrame(QImage image)
+void ObjectTracker::processFrame(QImage image, qint64 timestampUsecs)
 {
+    // blocks while the pipeline is full, further frames wait in the event queue as before
     if (_aruco) {
-        auto markers = _aruco->detectMarkers(image);
-        auto angles = _aruco->calc2dAngles(markers);
+        Frame frame;
+        frame.image = image;
+        frame.timestampUsecs = timestampUsecs;
+        frame.captureUsecs = timestampUsecs >= 0 ? timestampUsecs : std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        _capturedFrames.push(std::move(frame));
+    }
+}
+
+void ObjectTracker::detectionStage()
+{
+    Frame frame;
+    while (_capturedFrames.pop(frame)) {
+        QElapsedTimer stageTimer;
+        stageTimer.start();
 
+        const QImage image = frame.image;
+        int detectionInterval;
+        float maxFlowError;
+        bool skipStaticFrames;
+        bool adaptiveQuality;
+        double nearestDepth;
+        double farthestDepth;
         {
             QMutexLocker lock(&_mutex);
-            const float msecsPerFrame = 1000 / _framesPerSecond;
-            QSet<int> foundIds;
-            bool newIdAdded = false;
-            for (size_t i = 0; i < markers.ids.size(); ++i) {
-                const int id = markers.ids.at(i);
-                foundIds << id;
-
-                if (!_idToMarker.contains(id)) {
-                    newIdAdded = true;
-                    _idToMarker[id] = new Marker(id);
+            frame.boards = _boards;
+            frame.msecsPerFrame = 1000 / _framesPerSecond;
+            detectionInterval = _detectionInterval;
+            maxFlowError = _maxFlowError;
+            skipStaticFrames = _skipStaticFrames;
+            adaptiveQuality = _adaptiveQuality;
+            nearestDepth = _nearestDepth;
+            farthestDepth = _farthestDepth;
+        }
+
+        // a dropped frame or another camera rate shows in the timestamps, a replay that loops runs backwards
+        const qint64 gapUsecs = frame.timestampUsecs - _lastTimestampUsecs;
+        const bool validGap = frame.timestampUsecs >= 0 && _lastTimestampUsecs >= 0 && gapUsecs > 0 && gapUsecs <= MAX_FRAME_GAP_USECS;
+        frame.elapsedMsecs = validGap ? gapUsecs / 1000.0f : frame.msecsPerFrame;
+        _lastTimestampUsecs = frame.timestampUsecs;
+
+        if (!adaptiveQuality) {
+            _governor.reset();
+        }
+        _governor.setBudget(frame.msecsPerFrame);
+
+        // under load the filters predict the frames in between detections
+        frame.detected = ++_framesSinceProcessed >= _governor.detectionInterval();
+        frame.changed = false;
+        if (frame.detected) {
+            _framesSinceProcessed = 0;
+            if (!skipStaticFrames) {
+                _sceneChangeDetector.reset();
+            }
+            frame.changed = !skipStaticFrames || _sceneChangeDetector.hasChanged(image);
+            if (frame.changed) {
+                _lastMarkers = findMarkers(image, frame.boards.data(), detectionInterval, maxFlowError, _governor.detectionScale(), nearestDepth, farthestDepth);
+                frame.markers = _lastMarkers;
+            }
+        }
+
+        // throughput is set by the slowest stage
+        const float msecs = std::max({ stageTimer.nsecsElapsed() / 1e6f, _poseStageUsecs / 1e3f, _filterStageUsecs / 1e3f });
+        updateQualityLevel(msecs, frame.changed);
+
+        if (!_detectedFrames.push(std::move(frame)))
+            break;
+    }
+    _detectedFrames.close();
+}
+
+void ObjectTracker::poseStage()
+{
+    Frame frame;
+    while (_detectedFrames.pop(frame)) {
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+
+        if (!frame.changed) {
+            frame.markers = _posedMarkers;
+        } else {
+            // one pose per rigid object instead of one per marker, unchanged poses are kept for a static scene
+            _aruco->estimatePoses(frame.markers, frame.boards.data());
+            _posedMarkers = frame.markers;
+
+            _boardPoses.clear();
+            if (frame.boards) {
+                for (const auto& board : *frame.boards) {
+                    cv::Vec3d rvec, tvec;
+                    if (_aruco->estimateBoardPose(board, frame.markers, rvec, tvec) > 0) {
+                        _boardPoses.push_back({ board.id(), QVector3D(tvec[0], tvec[1], tvec[2]), toQuaternion(rvec) });
+                    }
                 }
-                auto tvec = markers.tvecs.at(i);
-                auto rvec = markers.rvecs.at(i);
-                float angle = angles.at(i);
-                _idToMarker[id]->setPositionRotation(QVector3D(tvec[0], tvec[1], tvec[2]), angle, msecsPerFrame);
             }
-            auto missingIds = _idToMarker.keys().toSet() - foundIds;
-            for (auto id : missingIds) {
-                _idToMarker[id]->setNotDetected(msecsPerFrame);
+        }
+        frame.boardPoses = _boardPoses;
+
+        _poseStageUsecs = int(stageTimer.nsecsElapsed() / 1000);
+        if (!_posedFrames.push(std::move(frame)))
+            break;
+    }
+    _posedFrames.close();
+}
+
+void ObjectTracker::filterStage()
+{
+    Frame frame;
+    while (_posedFrames.pop(frame)) {
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+
+        int markerTimeout;
+        {
+            QMutexLocker lock(&_mutex);
+            markerTimeout = _markerTimeout;
+        }
+
+        if (frame.detected) {
+            _markerTable.clearFound();
+            for (const auto& pose : frame.boardPoses) {
+                if (auto marker = _markerTable.markerFor(pose.id)) {
+                    marker->setPositionRotation(pose.pos, pose.rotation);
+                    _markerTable.setFound(pose.id);
+                }
+            }
+            for (int i = 0; i < frame.markers.count; ++i) {
+                const int id = frame.markers.ids[i];
+                if (MarkerBoard::anyContains(frame.boards.data(), id))
+                    continue;
+                // the first of duplicate ids is the one RefinementPolicy refined
+                if (std::find(frame.markers.ids, frame.markers.ids + i, id) != frame.markers.ids + i)
+                    continue;
+
+                auto tvec = frame.markers.tvecs[i];
+                _markerTable.markerFor(id)->setPositionRotation(QVector3D(tvec[0], tvec[1], tvec[2]), toQuaternion(frame.markers.rvecs[i]));
+                _markerTable.setFound(id);
+            }
+            _markerTable.forEachMissing([](Marker& marker) { marker.setNotDetected(); });
+            _markers = frame.markers;
+        }
+        // all tracks at once, the missing ones and frames without detection only predict
+        _filters.step(frame.elapsedMsecs);
+        for (int i = 0; i < _markerTable.size(); ++i) {
+            _markerTable.at(i).step(frame.elapsedMsecs);
+        }
+        if (markerTimeout > 0) {
+            evictMarkers(markerTimeout);
+        }
+        publishPoses(frame.captureUsecs);
+
+        double nearestDepth, farthestDepth;
+        expectedDepthRange(nearestDepth, farthestDepth);
+        {
+            QMutexLocker lock(&_mutex);
+            _nearestDepth = nearestDepth;
+            _farthestDepth = farthestDepth;
+        }
+
+        // the buffers are reused, copying into them does not allocate once they have grown
+        Snapshot& snapshot = _snapshots.writeBuffer();
+        snapshot.version = ++_version;
+        snapshot.image = frame.image;
+        snapshot.markers = _markers;
+        snapshot.markerStates.clear();
+        for (int i = 0; i < _markerTable.size(); ++i) {
+            snapshot.markerStates.push_back(_markerTable.at(i).state());
+        }
+        _snapshots.publish();
+
+        _filterStageUsecs = int(stageTimer.nsecsElapsed() / 1000);
+        emit imageChanged(frame.image);
+    }
+}
+
+void ObjectTracker::updateQualityLevel(float processMsecs, bool detected)
+{
+    if (!_governor.addFrameTime(processMsecs, detected) && _governor.level() == qualityLevel())
+        return;
+
+    const int level = _governor.level();
+    {
+        QMutexLocker lock(&_mutex);
+        _qualityLevel = level;
+    }
+    emit qualityLevelChanged(level);
+}
+
+Aruco::Markers ObjectTracker::findMarkers(QImage image, const std::vector<MarkerBoard>* boards, int detectionInterval, float maxFlowError, double detectionScale, double nearestDepth, double farthestDepth)
+{
+    // corners only, the pose stage solves the poses of the returned markers
+    if (detectionInterval > 1) {
+        if (_framesSinceDetection < detectionInterval && _lastMarkers.count > 0) {
+            Aruco::Markers markers = _lastMarkers;
+            _cornerTracker.setMaxFlowError(maxFlowError);
+            if (_cornerTracker.track(image, markers) && _aruco->verifyMarkers(image, markers)) {
+                _framesSinceDetection++;
+                return markers;
             }
+        } else {
+            _cornerTracker.setReference(image);
+        }
+    }
+
+    _framesSinceDetection = 1;
+
+    if (++_framesSinceFullSearch >= FULL_SEARCH_INTERVAL) {
+        _framesSinceFullSearch = 0;
+        nearestDepth = farthestDepth = 0;
+    }
+    auto markers = _aruco->detectMarkers(image, detectionScale, nearestDepth, farthestDepth);
+
+    // refine the markers that matter
+    QElapsedTimer refinementTimer;
+    refinementTimer.start();
+    _aruco->refineCorners(image, markers, _refinementPolicy.choose(markers, _lastMarkers, boards, detectionScale));
+    _refinementPolicy.addRefinementTime(refinementTimer.nsecsElapsed() / 1e6f);
+    return markers;
+}
 
-            _image = image;
-            _markers = markers;
+void ObjectTracker::expectedDepthRange(double& nearestDepth, double& farthestDepth) const
+{
+    nearestDepth = farthestDepth = 0;
+    for (int i = 0; i < _markerTable.size(); ++i) {
+        const Marker& marker = _markerTable.at(i);
+        if (marker.isDetectedFiltered()) {
+            const double z = marker.filteredPos().z();
+            nearestDepth = nearestDepth > 0 ? std::min(nearestDepth, z) : z;
+            farthestDepth = std::max(farthestDepth, z);
         }
+    }
+    nearestDepth *= 1 - DEPTH_MARGIN;
+    farthestDepth *= 1 + DEPTH_MARGIN;
+}
 
-        emit imageChanged(image);
+bool ObjectTracker::loadBoards(QString filename)
+{
+    bool ok = false;
+    QSharedPointer<const std::vector<MarkerBoard>> boards(new std::vector<MarkerBoard>(MarkerBoard::load(filename, &ok)));
+    if (ok) {
+        QMutexLocker lock(&_mutex);
+        _boards = boards;
     }
+    return ok;
 }
 
-QMutex* ObjectTracker::mutex()
+const ObjectTracker::Snapshot& ObjectTracker::snapshot()
 {
-    return &_mutex;
+    return _snapshots.read();
 }
 
-QImage ObjectTracker::image() const
+void ObjectTracker::publishPoses(qint64 captureUsecs)
 {
-    return _image;
+    for (int i = 0; i < _markerTable.size(); ++i) {
+        const Marker& marker = _markerTable.at(i);
+        if (marker.id() < POSE_TABLE_SIZE) {
+            PublishedPose published;
+            published.valid = marker.isDetectedFiltered();
+            published.pose = { captureUsecs, marker.filteredPos(), marker.filteredVelocity(), marker.filteredRotation(), marker.angularVelocity() };
+            _poses[marker.id()].store(published);
+        }
+    }
 }
 
-const Aruco::Markers& ObjectTracker::markers() const
+void ObjectTracker::evictMarkers(int timeoutMsecs)
 {
-    return _markers;
+    // from the back, the marker that moves into a freed index has been checked already
+    for (int i = _markerTable.size() - 1; i >= 0; --i) {
+        const Marker& marker = _markerTable.at(i);
+        if (marker.msecsSinceMeasured() <= timeoutMsecs)
+            continue;
+
+        const int id = marker.id();
+        if (id < POSE_TABLE_SIZE) {
+            PublishedPose published;
+            published.valid = false;
+            published.pose = Pose();
+            _poses[id].store(published);
+        }
+        _markerTable.remove(id);
+    }
 }
 
-QMap<int, Marker*> ObjectTracker::idToMarker() const
+bool ObjectTracker::poseAt(int id, qint64 timestampUsecs, Pose& pose) const
 {
-    return _idToMarker;
+    if (id < 0 || id >= POSE_TABLE_SIZE)
+        return false;
+
+    const PublishedPose published = _poses[id].load();
+    if (!published.valid)
+        return false;
+
+    // constant velocity and angular velocity, as the filters predict
+    const float msecs = (timestampUsecs - published.pose.timestampUsecs) / 1000.0f;
+    pose = published.pose;
+    pose.timestampUsecs = timestampUsecs;
+    pose.position += pose.velocity * msecs;
+    pose.rotation = (pose.rotation * OrientationFilter::fromRotationVector(pose.angularVelocity * msecs)).normalized();
+    return true;
 }
 
 float ObjectTracker::framesPerSecond() const
 {
+    QMutexLocker lock(&_mutex);
     return _framesPerSecond;
 }
 
 void ObjectTracker::setFramesPerSecond(float framesPerSecond)
 {
-    if (qFuzzyCompare(_framesPerSecond, framesPerSecond))
-        return;
+    {
+        QMutexLocker lock(&_mutex);
+        if (qFuzzyCompare(_framesPerSecond, framesPerSecond))
+            return;
+
+        _framesPerSecond = framesPerSecond;
+    }
+    emit framesPerSecondChanged(framesPerSecond);
+}
+
+int ObjectTracker::detectionInterval() const
+{
+    QMutexLocker lock(&_mutex);
+    return _detectionInterval;
+}
+
+void ObjectTracker::setDetectionInterval(int detectionInterval)
+{
+    detectionInterval = qMax(1, detectionInterval);
+    {
+        QMutexLocker lock(&_mutex);
+        if (_detectionInterval == detectionInterval)
+            return;
 
-    _framesPerSecond = framesPerSecond;
-    emit framesPerSecondChanged(_framesPerSecond);
+        _detectionInterval = detectionInterval;
+    }
+    emit detectionIntervalChanged(detectionInterval);
+}
+
+float ObjectTracker::maxFlowError() const
+{
+    QMutexLocker lock(&_mutex);
+    return _maxFlowError;
+}
+
+void ObjectTracker::setMaxFlowError(float maxFlowError)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        if (qFuzzyCompare(_maxFlowError, maxFlowError))
+            return;
+
+        _maxFlowError = maxFlowError;
+    }
+    emit maxFlowErrorChanged(maxFlowError);
+}
+
+bool ObjectTracker::skipStaticFrames() const
+{
+    QMutexLocker lock(&_mutex);
+    return _skipStaticFrames;
+}
+
+void ObjectTracker::setSkipStaticFrames(bool skipStaticFrames)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        if (_skipStaticFrames == skipStaticFrames)
+            return;
+
+        _skipStaticFrames = skipStaticFrames;
+    }
+    emit skipStaticFramesChanged(skipStaticFrames);
+}
+
+bool ObjectTracker::adaptiveQuality() const
+{
+    QMutexLocker lock(&_mutex);
+    return _adaptiveQuality;
+}
+
+void ObjectTracker::setAdaptiveQuality(bool adaptiveQuality)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        if (_adaptiveQuality == adaptiveQuality)
+            return;
+
+        _adaptiveQuality = adaptiveQuality;
+    }
+    emit adaptiveQualityChanged(adaptiveQuality);
+}
+
+int ObjectTracker::markerTimeout() const
+{
+    QMutexLocker lock(&_mutex);
+    return _markerTimeout;
+}
+
+void ObjectTracker::setMarkerTimeout(int markerTimeout)
+{
+    markerTimeout = qMax(0, markerTimeout);
+    {
+        QMutexLocker lock(&_mutex);
+        if (_markerTimeout == markerTimeout)
+            return;
+
+        _markerTimeout = markerTimeout;
+    }
+    emit markerTimeoutChanged(markerTimeout);
+}
+
+int ObjectTracker::qualityLevel() const
+{
+    QMutexLocker lock(&_mutex);
+    return _qualityLevel;
 }
@@ -16,44 +16,187 @@
 */
 #pragma once
 #include "Aruco/Aruco.h"
-#include <QMap>
+#include "Aruco/CornerTracker.h"
+#include "Aruco/MarkerBoard.h"
+#include "BoundedQueue.h"
+#include "Kalman/KalmanFilterBank.h"
+#include "LoadGovernor.h"
+#include "MarkerTable.h"
+#include "RefinementPolicy.h"
+#include "SceneChangeDetector.h"
+#include "SeqLock.h"
+#include "TripleBuffer.h"
 #include <QMutex>
 #include <QObject>
+#include <QQuaternion>
+#include <QSharedPointer>
+#include <QVector3D>
+#include <atomic>
+#include <memory>
+#include <vector>
 
-class Marker;
+class QThread;
 
+// Frames pass three stages, each on its own thread: detection, pose estimation and filtering with
+// publication. Bounded queues connect the stages, so frame N + 1 is detected while frame N is
+// filtered, and the filters see the frames in order.
 class ObjectTracker : public QObject {
     Q_OBJECT
     Q_PROPERTY(float framesPerSecond READ framesPerSecond WRITE setFramesPerSecond NOTIFY framesPerSecondChanged)
+    Q_PROPERTY(int detectionInterval READ detectionInterval WRITE setDetectionInterval NOTIFY detectionIntervalChanged)
+    Q_PROPERTY(float maxFlowError READ maxFlowError WRITE setMaxFlowError NOTIFY maxFlowErrorChanged)
+    Q_PROPERTY(bool skipStaticFrames READ skipStaticFrames WRITE setSkipStaticFrames NOTIFY skipStaticFramesChanged)
+    Q_PROPERTY(bool adaptiveQuality READ adaptiveQuality WRITE setAdaptiveQuality NOTIFY adaptiveQualityChanged)
+    Q_PROPERTY(int qualityLevel READ qualityLevel NOTIFY qualityLevelChanged)
+    Q_PROPERTY(int markerTimeout READ markerTimeout WRITE setMarkerTimeout NOTIFY markerTimeoutChanged)
 
 public:
+    // everything the user interface shows of one processed frame
+    struct Snapshot {
+        Snapshot();
+
+        quint64 version;
+        QImage image;
+        Aruco::Markers markers;
+        std::vector<MarkerState> markerStates;
+    };
+
+    // filtered pose of a marker or board, velocities are per millisecond and the angular velocity
+    // is in the marker frame
+    struct Pose {
+        qint64 timestampUsecs;
+        QVector3D position;
+        QVector3D velocity;
+        QQuaternion rotation;
+        QVector3D angularVelocity;
+    };
+
     explicit ObjectTracker(Aruco* aruco, QObject* parent = nullptr);
     virtual ~ObjectTracker() override;
 
-    void processFrame(QImage image);
-
-    QMutex* mutex();
+    // the filters advance by the difference between capture timestamps in microseconds, by the
+    // frame period of framesPerSecond for frames without a usable timestamp
+    void processFrame(QImage image, qint64 timestampUsecs = -1);
+    Q_INVOKABLE bool loadBoards(QString filename);
 
-    // *** methods below must be called with locked mutex -->
+    // full detection runs every detectionInterval frames, optical flow follows the markers in between
+    int detectionInterval() const;
+    void setDetectionInterval(int detectionInterval);
+    float maxFlowError() const;
+    void setMaxFlowError(float maxFlowError);
+    // reuse the previous markers as long as the scene does not change
+    bool skipStaticFrames() const;
+    void setSkipStaticFrames(bool skipStaticFrames);
+    // lower the detection resolution and rate when a frame takes longer than the frame period
+    bool adaptiveQuality() const;
+    void setAdaptiveQuality(bool adaptiveQuality);
+    // 0 is full quality, see LoadGovernor for the other levels
+    int qualityLevel() const;
+    // msecs without measurement after which a marker and its filters are freed, 0 keeps them forever
+    int markerTimeout() const;
+    void setMarkerTimeout(int markerTimeout);
 
     float framesPerSecond() const;
     void setFramesPerSecond(float framesPerSecond);
 
-    QImage image() const;
-    const Aruco::Markers& markers() const;
-    QMap<int, Marker*> idToMarker() const;
+    // latest processed frame without blocking the tracker, only ever read from one thread, the
+    // reference stays valid until the next call
+    const Snapshot& snapshot();
 
-    // <-- end mutex lock ***
+    // the pose of an id extrapolated to a timestamp on the clock of the capture timestamps, the
+    // monotonic clock for a live camera; lock-free from any thread, false for an id without pose
+    bool poseAt(int id, qint64 timestampUsecs, Pose& pose) const;
 
 signals:
     void framesPerSecondChanged(float framesPerSecond);
+    void detectionIntervalChanged(int detectionInterval);
+    void maxFlowErrorChanged(float maxFlowError);
+    void skipStaticFramesChanged(bool skipStaticFrames);
+    void adaptiveQualityChanged(bool adaptiveQuality);
+    void qualityLevelChanged(int qualityLevel);
+    void markerTimeoutChanged(int markerTimeout);
     void imageChanged(QImage image);
 
+private:
+    struct ObjectPose {
+        int id;
+        QVector3D pos;
+        QQuaternion rotation;
+    };
+
+    struct Frame {
+        QImage image;
+        qint64 timestampUsecs;
+        // when the image was captured, its arrival for frames without timestamp
+        qint64 captureUsecs;
+        QSharedPointer<const std::vector<MarkerBoard>> boards;
+        // processing budget and time since the previous frame
+        float msecsPerFrame;
+        float elapsedMsecs;
+        // without detection the filters only predict, an unchanged scene reuses the previous poses
+        bool detected;
+        bool changed;
+        Aruco::Markers markers;
+        std::vector<ObjectPose> boardPoses;
+    };
+
+    void detectionStage();
+    void poseStage();
+    void filterStage();
+
+    Aruco::Markers findMarkers(QImage image, const std::vector<MarkerBoard>* boards, int detectionInterval, float maxFlowError, double detectionScale, double nearestDepth, double farthestDepth);
+    void updateQualityLevel(float processMsecs, bool detected);
+    void expectedDepthRange(double& nearestDepth, double& farthestDepth) const;
+    void publishPoses(qint64 captureUsecs);
+    void evictMarkers(int timeoutMsecs);
+
 private:
     mutable QMutex _mutex;
-    QImage _image;
     Aruco* const _aruco;
-    Aruco::Markers _markers;
-    QMap<int, Marker*> _idToMarker;
     float _framesPerSecond;
+    QSharedPointer<const std::vector<MarkerBoard>> _boards;
+    int _detectionInterval;
+    float _maxFlowError;
+    bool _skipStaticFrames;
+    bool _adaptiveQuality;
+    int _qualityLevel;
+    int _markerTimeout;
+    double _nearestDepth;
+    double _farthestDepth;
+
+    BoundedQueue<Frame> _capturedFrames;
+    BoundedQueue<Frame> _detectedFrames;
+    BoundedQueue<Frame> _posedFrames;
+    QList<QThread*> _stageThreads;
+    std::atomic<int> _poseStageUsecs;
+    std::atomic<int> _filterStageUsecs;
+
+    // detection stage only
+    qint64 _lastTimestampUsecs;
+    Aruco::Markers _lastMarkers;
+    CornerTracker _cornerTracker;
+    int _framesSinceDetection;
+    SceneChangeDetector _sceneChangeDetector;
+    LoadGovernor _governor;
+    int _framesSinceProcessed;
+    int _framesSinceFullSearch;
+    RefinementPolicy _refinementPolicy;
+
+    // pose stage only
+    Aruco::Markers _posedMarkers;
+    std::vector<ObjectPose> _boardPoses;
+
+    // filter stage only
+    Aruco::Markers _markers;
+    KalmanFilterBank _filters;
+    MarkerTable _markerTable;
+    quint64 _version;
+    TripleBuffer<Snapshot> _snapshots;
+
+    struct PublishedPose {
+        bool valid;
+        Pose pose;
+    };
+    // indexed by id, allocated once so readers never see it move
+    std::unique_ptr<SeqLock<PublishedPose>[]> _poses;
 };
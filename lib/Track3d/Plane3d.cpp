@@ -15,9 +15,15 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "Plane3d.h"
+#include <algorithm>
 #include <math.h>
 #include <opencv2/core.hpp>
 
+namespace {
+// the second largest spread of the points must be this fraction of the largest to span a plane
+const double MIN_SPREAD_RATIO = 1e-9;
+}
+
 Plane3d::Plane3d(double a, double b, double c, double d)
     : _a(a)
     , _b(b)
@@ -97,3 +103,124 @@ double Plane3d::zAngle() const
 {
     return acos(_c / _l2abc);
 }
+
+PlaneFitter::PlaneFitter()
+{
+    clear();
+}
+
+void PlaneFitter::add(const QVector3D& point)
+{
+    if (_count == 0) {
+        _origin = point;
+    }
+    const double x = point.x() - _origin.x();
+    const double y = point.y() - _origin.y();
+    const double z = point.z() - _origin.z();
+    _sum[0] += x;
+    _sum[1] += y;
+    _sum[2] += z;
+    _sumSquares[0] += x * x;
+    _sumSquares[1] += x * y;
+    _sumSquares[2] += x * z;
+    _sumSquares[3] += y * y;
+    _sumSquares[4] += y * z;
+    _sumSquares[5] += z * z;
+    ++_count;
+}
+
+void PlaneFitter::remove(const QVector3D& point)
+{
+    if (_count <= 1) {
+        clear();
+        return;
+    }
+    const double x = point.x() - _origin.x();
+    const double y = point.y() - _origin.y();
+    const double z = point.z() - _origin.z();
+    _sum[0] -= x;
+    _sum[1] -= y;
+    _sum[2] -= z;
+    _sumSquares[0] -= x * x;
+    _sumSquares[1] -= x * y;
+    _sumSquares[2] -= x * z;
+    _sumSquares[3] -= y * y;
+    _sumSquares[4] -= y * z;
+    _sumSquares[5] -= z * z;
+    --_count;
+}
+
+void PlaneFitter::clear()
+{
+    _count = 0;
+    _origin = QVector3D();
+    std::fill(_sum, _sum + 3, 0.0);
+    std::fill(_sumSquares, _sumSquares + 6, 0.0);
+}
+
+int PlaneFitter::count() const
+{
+    return _count;
+}
+
+Plane3d PlaneFitter::fit(bool* ok) const
+{
+    Plane3d result;
+    bool hasPlane = false;
+
+    if (_count >= 3) {
+        // covariance of the points
+        const double mean[3] = { _sum[0] / _count, _sum[1] / _count, _sum[2] / _count };
+        const double c00 = _sumSquares[0] / _count - mean[0] * mean[0];
+        const double c01 = _sumSquares[1] / _count - mean[0] * mean[1];
+        const double c02 = _sumSquares[2] / _count - mean[0] * mean[2];
+        const double c11 = _sumSquares[3] / _count - mean[1] * mean[1];
+        const double c12 = _sumSquares[4] / _count - mean[1] * mean[2];
+        const double c22 = _sumSquares[5] / _count - mean[2] * mean[2];
+
+        // eigenvalues of the symmetric 3x3 matrix in closed form (trigonometric solution)
+        const double q = (c00 + c11 + c22) / 3;
+        const double offDiagonal = c01 * c01 + c02 * c02 + c12 * c12;
+        const double p = sqrt(((c00 - q) * (c00 - q) + (c11 - q) * (c11 - q) + (c22 - q) * (c22 - q) + 2 * offDiagonal) / 6);
+        if (p > 0) {
+            const double b00 = (c00 - q) / p, b11 = (c11 - q) / p, b22 = (c22 - q) / p;
+            const double b01 = c01 / p, b02 = c02 / p, b12 = c12 / p;
+            const double r = (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02)) / 2;
+            const double phi = acos(qBound(-1.0, r, 1.0)) / 3;
+            const double largest = q + 2 * p * cos(phi);
+            const double smallest = q + 2 * p * cos(phi + 2 * M_PI / 3);
+            const double middle = 3 * q - largest - smallest;
+
+            if (middle > MIN_SPREAD_RATIO * largest) {
+                // the normal is the eigenvector of the smallest eigenvalue: the rows of
+                // C - smallest * I span the plane it is orthogonal to, take the best conditioned cross product
+                const cv::Vec3d row0(c00 - smallest, c01, c02);
+                const cv::Vec3d row1(c01, c11 - smallest, c12);
+                const cv::Vec3d row2(c02, c12, c22 - smallest);
+                const cv::Vec3d candidates[3] = { row0.cross(row1), row0.cross(row2), row1.cross(row2) };
+                cv::Vec3d normal = candidates[0];
+                for (const auto& candidate : candidates) {
+                    if (candidate.dot(candidate) > normal.dot(normal)) {
+                        normal = candidate;
+                    }
+                }
+                normal = cv::normalize(normal);
+                double d = -(normal[0] * (mean[0] + _origin.x()) + normal[1] * (mean[1] + _origin.y()) + normal[2] * (mean[2] + _origin.z()));
+
+                // same scale as fitToPoints, which solves with a + b + c + d = 1
+                const double sum = normal[0] + normal[1] + normal[2] + d;
+                if (qAbs(sum) > MIN_SPREAD_RATIO * (1 + qAbs(d))) {
+                    normal /= sum;
+                    d /= sum;
+                }
+                result = Plane3d(normal[0], normal[1], normal[2], d);
+                hasPlane = true;
+            }
+        }
+    }
+
+    if (ok) {
+        *ok = hasPlane;
+    }
+    return result;
+}
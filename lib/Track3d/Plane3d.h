@@ -39,3 +39,27 @@ private:
     double _a, _b, _c, _d;
     double _l2abc;
 };
+
+// Least squares plane through a changing set of points. Only the running first and second
+// moments are kept, so adding, removing and refitting cost the same for any number of points.
+class PlaneFitter
+{
+public:
+    PlaneFitter();
+
+    void add(const QVector3D& point);
+    void remove(const QVector3D& point);
+    void clear();
+    int count() const;
+
+    // the plane with the smallest squared distances to the points, scaled like
+    // Plane3d::fitToPoints; fails for less than 3 points or points on a line
+    Plane3d fit(bool* ok) const;
+
+private:
+    int _count;
+    // moments are taken around the first point, large coordinates would cancel out otherwise
+    QVector3D _origin;
+    double _sum[3];
+    double _sumSquares[6]; // xx, xy, xz, yy, yz, zz
+};
@@ -0,0 +1,114 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "RefinementPolicy.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// cost of a fast refinement in full refinements, from the window areas and iteration counts
+const float FAST_REFINEMENT_COST = 0.1f;
+const float SMOOTHING = 0.1f;
+
+float perimeter(const cv::Point2f* corners)
+{
+    float result = 0;
+    for (int k = 0; k < 4; ++k) {
+        result += float(cv::norm(corners[k] - corners[(k + 1) % 4]));
+    }
+    return result;
+}
+
+// mean distance between the corners of two detections of a marker
+float cornerDistance(const cv::Point2f* corners, const cv::Point2f* previous)
+{
+    float result = 0;
+    for (int k = 0; k < 4; ++k) {
+        result += float(cv::norm(corners[k] - previous[k]));
+    }
+    return result / 4;
+}
+}
+
+RefinementPolicy::RefinementPolicy(float budgetMsecs, float minPerimeter, float staticDistance)
+    : _budget(budgetMsecs)
+    , _minPerimeter(minPerimeter)
+    , _staticDistance(staticDistance)
+    , _msecsPerFullRefinement(0.05f)
+    , _chosenCost(0)
+{
+}
+
+float RefinementPolicy::budget() const
+{
+    return _budget;
+}
+
+void RefinementPolicy::setBudget(float msecs)
+{
+    _budget = msecs;
+}
+
+const Aruco::RefineMethod* RefinementPolicy::choose(const Aruco::Markers& markers, const Aruco::Markers& previous, const std::vector<MarkerBoard>* boards, double detectionScale)
+{
+    const int count = markers.count;
+    const bool downscaled = detectionScale < 1.0;
+    for (int i = 0; i < count; ++i) {
+        _perimeters[i] = perimeter(markers.corners + 4 * i);
+    }
+    std::iota(_order, _order + count, 0);
+    std::sort(_order, _order + count, [&](int a, int b) { return _perimeters[a] > _perimeters[b]; });
+
+    _chosenCost = 0;
+    float msecs = 0;
+    for (int n = 0; n < count; ++n) {
+        const int i = _order[n];
+        const int id = markers.ids[i];
+        _methods[i] = Aruco::NoRefinement;
+
+        // only the first of duplicate ids updates a filter, ObjectTracker skips the others
+        if (std::find(markers.ids, markers.ids + i, id) != markers.ids + i)
+            continue;
+        if (!downscaled && _perimeters[i] < _minPerimeter)
+            continue;
+
+        // the filter averages the corner noise of a marker that stands still, board markers always
+        // move their board; it cannot average away the bias of downscaled corners
+        if (!downscaled && !MarkerBoard::anyContains(boards, id)) {
+            auto previousId = std::find(previous.ids, previous.ids + previous.count, id);
+            if (previousId != previous.ids + previous.count && cornerDistance(markers.corners + 4 * i, previous.corners + 4 * (previousId - previous.ids)) < _staticDistance)
+                continue;
+        }
+
+        if (msecs + _msecsPerFullRefinement <= _budget) {
+            _methods[i] = Aruco::FullRefinement;
+            msecs += _msecsPerFullRefinement;
+            _chosenCost += 1;
+        } else if (downscaled || msecs + FAST_REFINEMENT_COST * _msecsPerFullRefinement <= _budget) {
+            _methods[i] = Aruco::FastRefinement;
+            msecs += FAST_REFINEMENT_COST * _msecsPerFullRefinement;
+            _chosenCost += FAST_REFINEMENT_COST;
+        }
+    }
+    return _methods;
+}
+
+void RefinementPolicy::addRefinementTime(float msecs)
+{
+    if (_chosenCost > 0) {
+        _msecsPerFullRefinement += SMOOTHING * (msecs / _chosenCost - _msecsPerFullRefinement);
+    }
+}
@@ -0,0 +1,52 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "Aruco/Aruco.h"
+#include "Aruco/MarkerBoard.h"
+#include <vector>
+
+// Decides per detected marker how its corners are refined. Markers that do not update a filter,
+// are far away or stand still are not refined; the others get the best method that fits the
+// time budget, nearest markers first. Poses are only solved after refinement, so the apparent
+// size of a marker stands in for its depth and its corner motion for its movement. Corners
+// detected on a downscaled image are quantized to its coarser pixels, so then every marker that
+// updates a filter gets at least a fast refinement.
+class RefinementPolicy
+{
+public:
+    // minPerimeter and staticDistance in full resolution pixels
+    explicit RefinementPolicy(float budgetMsecs = 2.0f, float minPerimeter = 60.0f, float staticDistance = 1.0f);
+
+    float budget() const;
+    void setBudget(float msecs);
+
+    // a marker stands still when its corners are close to the ones in previous, detectionScale is
+    // the scale markers were detected at
+    const Aruco::RefineMethod* choose(const Aruco::Markers& markers, const Aruco::Markers& previous, const std::vector<MarkerBoard>* boards, double detectionScale = 1.0);
+    // refinement time of the methods returned by the last choose
+    void addRefinementTime(float msecs);
+
+private:
+    float _budget;
+    const float _minPerimeter;
+    const float _staticDistance;
+    float _msecsPerFullRefinement;
+    float _chosenCost;
+    Aruco::RefineMethod _methods[Aruco::Markers::CAPACITY];
+    float _perimeters[Aruco::Markers::CAPACITY];
+    int _order[Aruco::Markers::CAPACITY];
+};
@@ -0,0 +1,94 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "SceneChangeDetector.h"
+#include <algorithm>
+#include <stdlib.h>
+
+SceneChangeDetector::SceneChangeDetector(float threshold, int tileSize, int sampleStep)
+    : _threshold(threshold)
+    , _tileSize(tileSize)
+    , _sampleStep(sampleStep)
+    , _tilesPerRow(0)
+{
+}
+
+float SceneChangeDetector::threshold() const
+{
+    return _threshold;
+}
+
+void SceneChangeDetector::setThreshold(float threshold)
+{
+    _threshold = threshold;
+}
+
+bool SceneChangeDetector::hasChanged(const QImage& image)
+{
+    if (image.size().isEmpty() || image.format() != QImage::Format_RGB888)
+        return true;
+
+    if (image.size() != _size) {
+        reset();
+        _size = image.size();
+        _tilesPerRow = (_size.width() + _tileSize - 1) / _tileSize;
+        const int tileRows = (_size.height() + _tileSize - 1) / _tileSize;
+        _tileDifferences.resize(_tilesPerRow * tileRows);
+        _tileSamples.resize(_tilesPerRow * tileRows);
+    }
+
+    sample(image);
+    bool changed = _reference.size() != _samples.size();
+    if (!changed) {
+        std::fill(_tileDifferences.begin(), _tileDifferences.end(), 0);
+        std::fill(_tileSamples.begin(), _tileSamples.end(), 0);
+
+        size_t i = 0;
+        for (int y = 0; y < _size.height(); y += _sampleStep) {
+            const int tileRow = (y / _tileSize) * _tilesPerRow;
+            for (int x = 0; x < _size.width(); x += _sampleStep, ++i) {
+                const int tile = tileRow + x / _tileSize;
+                _tileDifferences[tile] += abs(int(_samples[i]) - int(_reference[i]));
+                _tileSamples[tile]++;
+            }
+        }
+        for (size_t tile = 0; !changed && tile < _tileDifferences.size(); ++tile) {
+            changed = _tileDifferences[tile] > _threshold * _tileSamples[tile];
+        }
+    }
+
+    if (changed) {
+        _reference.swap(_samples);
+    }
+    return changed;
+}
+
+void SceneChangeDetector::reset()
+{
+    _size = QSize();
+    _reference.clear();
+}
+
+void SceneChangeDetector::sample(const QImage& image)
+{
+    _samples.clear();
+    for (int y = 0; y < image.height(); y += _sampleStep) {
+        const uchar* line = image.constScanLine(y);
+        for (int x = 0; x < image.width(); x += _sampleStep) {
+            _samples.push_back(line[3 * x + 1]);
+        }
+    }
+}
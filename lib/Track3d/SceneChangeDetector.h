@@ -0,0 +1,49 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <QImage>
+#include <QSize>
+#include <vector>
+
+// Cheap test whether anything moved since the last processed frame: the mean absolute difference of a
+// subsampled green channel is compared per tile, so a single small moving marker still counts as a change.
+class SceneChangeDetector
+{
+public:
+    explicit SceneChangeDetector(float threshold = 4.0f, int tileSize = 32, int sampleStep = 4);
+
+    float threshold() const;
+    void setThreshold(float threshold);
+
+    // when image differs from the reference it becomes the new reference
+    bool hasChanged(const QImage& image);
+    void reset();
+
+private:
+    void sample(const QImage& image);
+
+private:
+    float _threshold;
+    const int _tileSize;
+    const int _sampleStep;
+    QSize _size;
+    int _tilesPerRow;
+    std::vector<uchar> _reference;
+    std::vector<uchar> _samples;
+    std::vector<int> _tileDifferences;
+    std::vector<int> _tileSamples;
+};
@@ -0,0 +1,78 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// One writer stores a small value, any number of readers load it without locks and without ever
+// holding up the writer. A reader that overlaps a store simply tries again. The value is kept in
+// atomic words, so a torn read is detected rather than undefined.
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+
+public:
+    SeqLock()
+        : _sequence(0)
+    {
+        for (auto& word : _words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // writer thread only
+    void store(const T& value)
+    {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const unsigned sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            _words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        uint64_t buffer[WORD_COUNT];
+        unsigned before, after;
+        do {
+            before = _sequence.load(std::memory_order_acquire);
+            for (int i = 0; i < WORD_COUNT; ++i) {
+                buffer[i] = _words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = _sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+private:
+    static const int WORD_COUNT = int((sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+
+    std::atomic<unsigned> _sequence;
+    std::atomic<uint64_t> _words[WORD_COUNT];
+};
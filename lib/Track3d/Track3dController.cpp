@@ -20,7 +20,7 @@
 #include "Plane3d.h"
 #include "Track3d/ObjectTracker.h"
 #include "Track3dInfo.h"
-#include <QMutexLocker>
+#include <QSet>
 #include <QTimer>
 #include <math.h>
 
@@ -31,6 +31,7 @@ Track3dController::Track3dController(QObject* parent)
     , _refreshTextCounter(0)
     , _objectTracker(nullptr)
     , _aruco(nullptr)
+    , _snapshotVersion(0)
 {
     _elapsedTime.start();
     _refreshFpsTimer = new QTimer(this);
@@ -84,19 +85,13 @@ void Track3dController::refreshImage()
     if (!_objectTracker)
         return;
 
-    QMutexLocker lock(_objectTracker->mutex());
-    QImage newImage = _objectTracker->image();
-
-    if (_image != newImage) {
-        _image = newImage;
-        _annotatedImage = newImage;
+    const auto& snapshot = _objectTracker->snapshot();
+    if (snapshot.version != _snapshotVersion) {
+        _snapshotVersion = snapshot.version;
+        _annotatedImage = snapshot.image;
 
         if (_aruco) {
-            auto markers = _objectTracker->markers();
-            lock.unlock();
-            _aruco->drawMarkers(_annotatedImage, markers);
-        } else {
-            lock.unlock();
+            _aruco->drawMarkers(_annotatedImage, snapshot.markers);
         }
 
         _framesCounter++;
@@ -106,34 +101,83 @@ void Track3dController::refreshImage()
 
         emit imageChanged();
 
+        updateRefPlane(snapshot.markerStates);
         if (++_refreshTextCounter == 15) {
-            refreshText();
+            refreshText(snapshot.markerStates);
             _refreshTextCounter = 0;
         }
     }
 }
 
-void Track3dController::refreshText()
+void Track3dController::refreshText(const std::vector<MarkerState>& markerStates)
 {
-    if (!_objectTracker)
-        return;
+    bool markersChanging = false;
+    for (const auto& marker : markerStates) {
+        if (!_markerInfos.contains(marker.id)) {
+            markersChanging = true;
+            _markerInfos[marker.id] = new Track3dInfo(marker.id, this);
+        }
+        _markerInfos[marker.id]->update(marker);
+    }
 
-    QMutexLocker lock(_objectTracker->mutex());
-    auto idToMarker = _objectTracker->idToMarker();
-    bool newIdAdded = false;
-    QList<QVector3D> points;
-    for (auto it = idToMarker.cbegin(); it != idToMarker.cend(); ++it) {
-        if (!_markerInfos.contains(it.key())) {
-            newIdAdded = true;
-            _markerInfos[it.key()] = new Track3dInfo(it.key(), this);
+    // every marker of the snapshot has its info now, any extra one was evicted by the tracker
+    if (_markerInfos.size() > int(markerStates.size())) {
+        QSet<int> ids;
+        for (const auto& marker : markerStates) {
+            ids.insert(marker.id);
+        }
+        for (auto info = _markerInfos.begin(); info != _markerInfos.end();) {
+            if (ids.contains(info.key())) {
+                ++info;
+            } else {
+                info.value()->deleteLater();
+                info = _markerInfos.erase(info);
+            }
+        }
+        markersChanging = true;
+    }
+
+    if (markersChanging) {
+        emit markersChanged();
+    }
+}
+
+void Track3dController::updateRefPlane(const std::vector<MarkerState>& markerStates)
+{
+    // only the points that moved are replaced in the running moments
+    int filteredCount = 0;
+    for (const auto& marker : markerStates) {
+        filteredCount += marker.isDetectedFiltered ? 1 : 0;
+        auto point = _planePoints.find(marker.id);
+        if (point != _planePoints.end()) {
+            if (marker.isDetectedFiltered && point.value() == marker.filteredPos)
+                continue;
+            _planeFitter.remove(point.value());
+            _planePoints.erase(point);
+        }
+        if (marker.isDetectedFiltered) {
+            _planeFitter.add(marker.filteredPos);
+            _planePoints.insert(marker.id, marker.filteredPos);
+        }
+    }
+    // the points of evicted markers
+    if (_planePoints.size() > filteredCount) {
+        QSet<int> ids;
+        for (const auto& marker : markerStates) {
+            ids.insert(marker.id);
+        }
+        for (auto point = _planePoints.begin(); point != _planePoints.end();) {
+            if (ids.contains(point.key())) {
+                ++point;
+            } else {
+                _planeFitter.remove(point.value());
+                point = _planePoints.erase(point);
+            }
         }
-        _markerInfos[it.key()]->update(it.value());
-        points << it.value()->filteredPos();
     }
-    lock.unlock();
 
     bool hasPlane = false;
-    auto plane = Plane3d::fitToPoints(points, &hasPlane);
+    auto plane = _planeFitter.fit(&hasPlane);
     if (hasPlane) {
         setRefPlane(
             QStringLiteral("xAngle=%1 yAngle=%2 zAngle=%3")
@@ -143,10 +187,6 @@ void Track3dController::refreshText()
     } else {
         setRefPlane(QStringLiteral("-"));
     }
-
-    if (newIdAdded) {
-        emit markersChanged();
-    }
 }
 
 qreal Track3dController::fps() const
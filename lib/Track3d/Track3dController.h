@@ -15,14 +15,17 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #pragma once
+#include "Plane3d.h"
 #include <Aruco/Aruco.h>
 #include <QElapsedTimer>
 #include <QImage>
 #include <QMap>
 #include <QObject>
+#include <vector>
 
 class Track3dInfo;
 class ObjectTracker;
+struct MarkerState;
 
 class Track3dController : public QObject {
     Q_OBJECT
@@ -60,13 +63,16 @@ private slots:
     void setFps(qreal fps);
     void updateFps();
     void refreshImage();
-    void refreshText();
+
+private:
+    void refreshText(const std::vector<MarkerState>& markerStates);
+    void updateRefPlane(const std::vector<MarkerState>& markerStates);
 
 private:
     ObjectTracker* _objectTracker;
     Aruco* _aruco;
 
-    QImage _image;
+    quint64 _snapshotVersion;
     QImage _annotatedImage;
     qreal _fps;
     int _framesCounter;
@@ -76,4 +82,7 @@ private:
     QTimer* _refreshFpsTimer;
     QMap<int, Track3dInfo*> _markerInfos;
     QString _refPlane;
+    // filtered position each marker contributes to the reference plane
+    QMap<int, QVector3D> _planePoints;
+    PlaneFitter _planeFitter;
 };
@@ -69,21 +69,21 @@ QString Track3dInfo::fangle() const
     return _fangle;
 }
 
-void Track3dInfo::update(Marker* marker)
+void Track3dInfo::update(const MarkerState& marker)
 {
-    if (marker->isDetected()) {
-        _x = QString::number(marker->pos().x(), 'f', 1);
-        _y = QString::number(marker->pos().y(), 'f', 1);
-        _z = QString::number(marker->pos().z(), 'f', 1);
-        _angle = QString::number(marker->angle() * 180 / M_PI, 'f', 1);
+    if (marker.isDetected) {
+        _x = QString::number(marker.pos.x(), 'f', 1);
+        _y = QString::number(marker.pos.y(), 'f', 1);
+        _z = QString::number(marker.pos.z(), 'f', 1);
+        _angle = QString::number(marker.angle * 180 / M_PI, 'f', 1);
     } else {
         _x = _y = _z = _angle = QStringLiteral("-");
     }
-    if (marker->isDetectedFiltered()) {
-        _fx = QString::number(marker->filteredPos().x(), 'f', 1);
-        _fy = QString::number(marker->filteredPos().y(), 'f', 1);
-        _fz = QString::number(marker->filteredPos().z(), 'f', 1);
-        _fangle = QString::number(marker->filteredAngle() * 180 / M_PI, 'f', 1);
+    if (marker.isDetectedFiltered) {
+        _fx = QString::number(marker.filteredPos.x(), 'f', 1);
+        _fy = QString::number(marker.filteredPos.y(), 'f', 1);
+        _fz = QString::number(marker.filteredPos.z(), 'f', 1);
+        _fangle = QString::number(marker.filteredAngle * 180 / M_PI, 'f', 1);
     } else {
         _fx = _fy = _fz = _fangle = QStringLiteral("-");
     }
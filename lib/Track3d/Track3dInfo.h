@@ -18,7 +18,7 @@
 #include <QObject>
 #include <QString>
 
-class Marker;
+struct MarkerState;
 
 class Track3dInfo : public QObject {
     Q_OBJECT
@@ -45,7 +45,7 @@ public:
     QString angle() const;
     QString fangle() const;
 
-    void update(Marker* marker);
+    void update(const MarkerState& marker);
 
 signals:
     void changed();
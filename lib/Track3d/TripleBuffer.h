@@ -0,0 +1,62 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <atomic>
+
+// Hands the latest value from one writer thread to one reader thread without locks. The writer
+// fills its own buffer and publishes it, the reader swaps in the newest published buffer, and
+// the third buffer in between lets both run freely: neither side ever waits for the other.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : _middle(1)
+        , _writeIndex(0)
+        , _readIndex(2)
+    {
+    }
+
+    // writer thread only, the buffer may hold an older value to reuse its memory
+    T& writeBuffer()
+    {
+        return _buffers[_writeIndex];
+    }
+
+    void publish()
+    {
+        _writeIndex = _middle.exchange(_writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // reader thread only, valid until the next call
+    const T& read()
+    {
+        if (_middle.load(std::memory_order_relaxed) & FRESH) {
+            _readIndex = _middle.exchange(_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return _buffers[_readIndex];
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;
+
+    T _buffers[3];
+    std::atomic<int> _middle;
+    int _writeIndex;
+    int _readIndex;
+};
@@ -17,16 +17,18 @@
 #include "Frame.h"
 #include <QtConcurrent/QtConcurrentRun>
 
-Frame::Frame(QDir path, QString fileName, QObject* parent)
+Frame::Frame(QDir path, QString fileName, qint64 timestampUsecs, QObject* parent)
     : QObject(parent)
     , _path(path)
     , _fileName(fileName)
+    , _timestampUsecs(timestampUsecs)
     , _needsLoadFromDisk(true)
 {
 }
 
 Frame::Frame(QImage image, QObject* parent)
     : QObject(parent)
+    , _timestampUsecs(-1)
     , _image(image)
     , _needsLoadFromDisk(false)
 {
@@ -41,6 +43,11 @@ QString Frame::fileName() const
     return _fileName;
 }
 
+qint64 Frame::timestampUsecs() const
+{
+    return _timestampUsecs;
+}
+
 QImage Frame::image()
 {
     if (_needsLoadFromDisk) {
@@ -50,6 +57,11 @@ QImage Frame::image()
     return _image;
 }
 
+QString Frame::filePath() const
+{
+    return _needsLoadFromDisk ? _path.absoluteFilePath(_fileName) : QString();
+}
+
 void Frame::loadImageFromDisk()
 {
     if (_needsLoadFromDisk && _imageFuture.isCanceled()) {
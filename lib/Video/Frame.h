@@ -27,12 +27,16 @@ class Frame : public QObject
     Q_PROPERTY(QImage image READ image CONSTANT)
 
 public:
-    explicit Frame(QDir path, QString fileName, QObject* parent = nullptr);
+    explicit Frame(QDir path, QString fileName, qint64 timestampUsecs = -1, QObject* parent = nullptr);
     explicit Frame(QImage image, QObject* parent = nullptr);
     virtual ~Frame() override;
 
     QString fileName() const;
+    // capture time in microseconds, -1 when the recording has none
+    qint64 timestampUsecs() const;
     QImage image();
+    // empty for a frame that is not on disk
+    QString filePath() const;
 
 public slots:
     void loadImageFromDisk();
@@ -40,6 +44,7 @@ public slots:
 private:
     const QDir _path;
     const QString _fileName;
+    const qint64 _timestampUsecs;
     QImage _image;
     bool _needsLoadFromDisk;
     QFuture<QImage> _imageFuture;
@@ -17,9 +17,29 @@
 #include "Video.h"
 #include "Frame.h"
 #include <QDir>
+#include <QFile>
+#include <QHash>
 
 namespace {
 const QStringList filter = QStringList() << (QStringLiteral("????????.JPG"));
+const QString TIMESTAMPS_FILENAME(QStringLiteral("timestamps.txt"));
+
+QHash<QString, qint64> loadTimestamps(const QDir& dir)
+{
+    QHash<QString, qint64> result;
+    QFile file(dir.absoluteFilePath(TIMESTAMPS_FILENAME));
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!file.atEnd()) {
+            const auto fields = QString::fromLatin1(file.readLine()).simplified().split(QChar(' '));
+            bool ok = false;
+            const qint64 timestamp = fields.size() == 2 ? fields.at(1).toLongLong(&ok) : 0;
+            if (ok) {
+                result.insert(fields.at(0), timestamp);
+            }
+        }
+    }
+    return result;
+}
 }
 
 Video::Video(QObject *parent) : QObject(parent)
@@ -39,8 +59,9 @@ void Video::load(QString path)
     _frames.clear();
 
     QDir dir(path);
+    const auto timestamps = loadTimestamps(dir);
     for (QString filename : dir.entryList(filter, QDir::Files | QDir::Readable, QDir::Name)) {
-        _frames.append(new Frame(dir, filename));
+        _frames.append(new Frame(dir, filename, timestamps.value(filename, -1)));
     }
     emit framesChanged();
 }
@@ -49,3 +70,8 @@ QList<Frame*> Video::frames() const
 {
     return _frames;
 }
+
+QString Video::timestampsFileName()
+{
+    return TIMESTAMPS_FILENAME;
+}
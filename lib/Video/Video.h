@@ -32,6 +32,9 @@ public:
 
     QList<Frame*> frames() const;
 
+    // capture timestamps of a recording, one "<file name> <microseconds>" line per frame
+    static QString timestampsFileName();
+
 signals:
     void framesChanging();
     void framesChanged();
@@ -22,18 +22,33 @@ include(../link_opencv.pri)
 
 HEADERS += \
     Aruco/Aruco.h \
+    Aruco/CornerTracker.h \
+    Aruco/DetectionStats.h \
+    Aruco/MarkerBoard.h \
+    Aruco/MarkerDecoder.h \
+    Aruco/PointUndistorter.h \
+    Aruco/SquarePose.h \
     Calibration/CalibrationController.h \
     Calibration/FramesCalibrationModel.h \
     Camera/Camera.h \
     Camera/CameraController.h \
     Calibration/CameraCalibration.h \
     Camera/CameraReader.h \
+    Kalman/KalmanFilter.h \
+    Kalman/KalmanFilterBank.h \
     Kalman/KalmanTracker1D.h \
     Kalman/KalmanTracker3D.h \
+    Kalman/OrientationFilter.h \
+    Kalman/RtsSmoother.h \
     Kalman/RotationCounter.h \
+    Track3d/LoadGovernor.h \
+    Track3d/BoundedQueue.h \
     Track3d/Marker.h \
+    Track3d/MarkerTable.h \
     Track3d/ObjectTracker.h \
     Track3d/Plane3d.h \
+    Track3d/RefinementPolicy.h \
+    Track3d/SceneChangeDetector.h \
     Track3d/Track3dController.h \
     Track3d/Track3dInfo.h \
     Video/Frame.h \
@@ -46,18 +61,31 @@ HEADERS += \
 
 SOURCES += \
     Aruco/Aruco.cpp \
+    Aruco/CornerTracker.cpp \
+    Aruco/DetectionStats.cpp \
+    Aruco/MarkerBoard.cpp \
+    Aruco/MarkerDecoder.cpp \
+    Aruco/PointUndistorter.cpp \
+    Aruco/SquarePose.cpp \
     Calibration/CalibrationController.cpp \
     Calibration/FramesCalibrationModel.cpp \
     Camera/Camera.cpp \
     Camera/CameraController.cpp \
     Calibration/CameraCalibration.cpp \
     Camera/CameraReader.cpp \
+    Kalman/KalmanFilterBank.cpp \
     Kalman/KalmanTracker1D.cpp \
     Kalman/KalmanTracker3D.cpp \
+    Kalman/OrientationFilter.cpp \
+    Kalman/RtsSmoother.cpp \
     Kalman/RotationCounter.cpp \
+    Track3d/LoadGovernor.cpp \
     Track3d/Marker.cpp \
+    Track3d/MarkerTable.cpp \
     Track3d/ObjectTracker.cpp \
     Track3d/Plane3d.cpp \
+    Track3d/RefinementPolicy.cpp \
+    Track3d/SceneChangeDetector.cpp \
     Track3d/Track3dController.cpp \
     Track3d/Track3dInfo.cpp \
     Video/Frame.cpp \
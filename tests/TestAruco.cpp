@@ -0,0 +1,81 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestAruco.h"
+#include "Aruco/Aruco.h"
+#include "TestFactory.h"
+#include <algorithm>
+#include <opencv2/aruco.hpp>
+#include <opencv2/imgproc.hpp>
+
+REGISTER_TESTCLASS(TestAruco);
+
+namespace {
+const int MARKER_PIXELS = 120;
+
+// white image with the markers side by side, each with a quiet zone around it
+QImage markerImage(const QList<int>& ids)
+{
+    auto dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_50);
+    QImage image(2 * MARKER_PIXELS * ids.size(), 2 * MARKER_PIXELS, QImage::Format_RGB888);
+    image.fill(Qt::white);
+    cv::Mat view(image.height(), image.width(), CV_8UC3, image.bits(), image.bytesPerLine());
+    for (int i = 0; i < ids.size(); ++i) {
+        cv::Mat marker;
+        cv::aruco::drawMarker(dictionary, ids[i], MARKER_PIXELS, marker);
+        cv::cvtColor(marker, marker, cv::COLOR_GRAY2RGB);
+        marker.copyTo(view(cv::Rect(2 * MARKER_PIXELS * i + MARKER_PIXELS / 2, MARKER_PIXELS / 2, MARKER_PIXELS, MARKER_PIXELS)));
+    }
+    return image;
+}
+
+QList<int> sortedIds(const Aruco::Markers& markers)
+{
+    QList<int> result;
+    for (int i = 0; i < markers.count; ++i) {
+        result << markers.ids[i];
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+}
+
+void TestAruco::setAllowedIds_should_reject_ids_outside_the_dictionary()
+{
+    Aruco aruco;
+    QVERIFY(aruco.setAllowedIds({ 17, 3 }));
+    QCOMPARE(aruco.allowedIds(), QList<int>({ 3, 17 }));
+
+    QVERIFY(!aruco.setAllowedIds({ -1, 50 }));
+    QVERIFY(!aruco.setAllowedIds({ 5, 50 }));
+    QCOMPARE(aruco.allowedIds(), QList<int>({ 3, 17 }));
+
+    QVERIFY(aruco.setAllowedIds({}));
+    QVERIFY(aruco.allowedIds().isEmpty());
+}
+
+void TestAruco::detectMarkers_should_report_allowed_ids()
+{
+    Aruco aruco;
+    const QImage image = markerImage({ 3, 5, 17 });
+    aruco.setCameraMatrix((cv::Mat_<double>(3, 3) << 800, 0, image.width() / 2, 0, 800, image.height() / 2, 0, 0, 1),
+        cv::Mat::zeros(1, 5, CV_64F));
+    QCOMPARE(sortedIds(aruco.detectMarkers(image)), QList<int>({ 3, 5, 17 }));
+
+    // the detector decodes against the subset, its indices are mapped back to the dictionary ids
+    QVERIFY(aruco.setAllowedIds({ 17, 3 }));
+    QCOMPARE(sortedIds(aruco.detectMarkers(image)), QList<int>({ 3, 17 }));
+}
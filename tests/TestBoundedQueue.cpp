@@ -0,0 +1,104 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestBoundedQueue.h"
+#include "TestFactory.h"
+#include "Track3d/BoundedQueue.h"
+#include <QThread>
+#include <atomic>
+#include <thread>
+
+REGISTER_TESTCLASS(TestBoundedQueue);
+
+namespace {
+// long enough for a thread that is not blocked to get through
+const int SETTLE_MSECS = 50;
+}
+
+void TestBoundedQueue::pop_should_return_items_in_order()
+{
+    BoundedQueue<int> queue(3);
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    QVERIFY(queue.push(3));
+
+    int item = 0;
+    for (int expected = 1; expected <= 3; ++expected) {
+        QVERIFY(queue.pop(item));
+        QCOMPARE(item, expected);
+    }
+}
+
+void TestBoundedQueue::push_should_block_while_full()
+{
+    BoundedQueue<int> queue(2);
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+
+    std::atomic<bool> pushed(false);
+    std::thread producer([&]() {
+        queue.push(3);
+        pushed = true;
+    });
+    QThread::msleep(SETTLE_MSECS);
+    QVERIFY(!pushed);
+
+    int item = 0;
+    QVERIFY(queue.pop(item));
+    QCOMPARE(item, 1);
+    producer.join();
+    QVERIFY(pushed);
+
+    QVERIFY(queue.pop(item));
+    QCOMPARE(item, 2);
+    QVERIFY(queue.pop(item));
+    QCOMPARE(item, 3);
+}
+
+void TestBoundedQueue::close_should_release_waiting_push()
+{
+    BoundedQueue<int> queue(1);
+    QVERIFY(queue.push(1));
+
+    std::atomic<int> result(-1);
+    std::thread producer([&]() { result = queue.push(2) ? 1 : 0; });
+    QThread::msleep(SETTLE_MSECS);
+    QCOMPARE(int(result), -1);
+
+    queue.close();
+    producer.join();
+    QCOMPARE(int(result), 0);
+    QVERIFY(!queue.push(3));
+}
+
+void TestBoundedQueue::close_should_release_waiting_pop()
+{
+    BoundedQueue<int> queue(1);
+
+    std::atomic<int> result(-1);
+    std::thread consumer([&]() {
+        int item = 0;
+        result = queue.pop(item) ? 1 : 0;
+    });
+    QThread::msleep(SETTLE_MSECS);
+    QCOMPARE(int(result), -1);
+
+    queue.close();
+    consumer.join();
+    QCOMPARE(int(result), 0);
+    int item = 0;
+    QVERIFY(!queue.pop(item));
+}
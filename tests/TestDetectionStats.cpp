@@ -0,0 +1,68 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestDetectionStats.h"
+#include "Aruco/DetectionStats.h"
+#include "TestFactory.h"
+
+REGISTER_TESTCLASS(TestDetectionStats);
+
+void TestDetectionStats::histogram_should_keep_last_window()
+{
+    RollingHistogram histogram(4);
+    for (int i = 1; i <= 10; ++i) {
+        histogram.add(i);
+    }
+
+    QCOMPARE(histogram.count(), 4);
+    QCOMPARE(histogram.mean(), 8.5f);
+    QCOMPARE(histogram.max(), 10.0f);
+    QCOMPARE(histogram.percentile(0.0f), 7.0f);
+    QCOMPARE(histogram.percentile(0.5f), 9.0f);
+    QCOMPARE(histogram.percentile(1.0f), 10.0f);
+}
+
+void TestDetectionStats::histogram_should_bin_samples()
+{
+    RollingHistogram histogram(10);
+    histogram.add(0.2f);
+    histogram.add(0.7f);
+    histogram.add(1.2f);
+    histogram.add(100.0f);
+
+    const std::vector<int> bins = histogram.bins(0.5f, 3);
+    QCOMPARE(bins.size(), size_t(3));
+    QCOMPARE(bins[0], 1);
+    QCOMPARE(bins[1], 1);
+    QCOMPARE(bins[2], 2);
+}
+
+void TestDetectionStats::stats_should_summarize_stages()
+{
+    DetectionStats stats(10);
+    stats.addTime(DetectionStats::Detection, 4.0f);
+    stats.addTime(DetectionStats::Detection, 6.0f);
+    stats.addCount(DetectionStats::Candidates, 12);
+
+    const QVariantMap map = stats.toVariantMap();
+    const QVariantMap detection = map["stages"].toMap()["detection"].toMap();
+    QCOMPARE(detection["count"].toInt(), 2);
+    QCOMPARE(detection["mean"].toFloat(), 5.0f);
+    QCOMPARE(map["counters"].toMap()["candidates"].toMap()["max"].toFloat(), 12.0f);
+
+    stats.clear();
+    QCOMPARE(stats.histogram(DetectionStats::Detection).count(), 0);
+}
@@ -0,0 +1,306 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestKalmanFilter.h"
+#include "Kalman/KalmanFilter.h"
+#include "Kalman/KalmanFilterBank.h"
+#include "Kalman/KalmanTracker3D.h"
+#include "Kalman/RtsSmoother.h"
+#include "TestFactory.h"
+#include <memory>
+#include <vector>
+#include <opencv2/video/tracking.hpp>
+
+REGISTER_TESTCLASS(TestKalmanFilter);
+
+namespace {
+const double TOLERANCE = 1e-9;
+
+// constant velocity model as the trackers used to set up cv::KalmanFilter
+cv::KalmanFilter openCvFilter(const KalmanTracker3D::Params& p)
+{
+    cv::KalmanFilter kf(6, 3, 0, CV_64F);
+    for (int i = 0; i < 3; ++i) {
+        kf.measurementMatrix.at<double>(i, i) = 1.0;
+        kf.measurementNoiseCov.at<double>(i, i) = i < 2 ? p.measurementXYNoiseCov : p.measurementZNoiseCov;
+        kf.processNoiseCov.at<double>(i, i) = i < 2 ? p.positionXYProcessNoiseCov : p.positionZProcessNoiseCov;
+        kf.processNoiseCov.at<double>(i + 3, i + 3) = i < 2 ? p.velocityXYProcessNoiseCov : p.velocityZProcessNoiseCov;
+    }
+    return kf;
+}
+
+// noisy detections of a marker moving at constant velocity, with gaps long enough to time out
+struct Recording {
+    explicit Recording(int frameCount, quint64 seed)
+    {
+        cv::RNG rng(seed);
+        QVector3D position(0, 0, 1000);
+        const QVector3D velocity(0.5f, -0.2f, 0.01f);
+        for (int frame = 0; frame < frameCount; ++frame) {
+            const double dt = frame % 1000 < 950 ? rng.uniform(10.0, 50.0) : 200.0;
+            position += velocity * float(dt);
+            elapsedMsecs.push_back(dt);
+            truth.push_back(position);
+            detected.push_back(frame % 1000 < 950 && frame % 7 != 0);
+            measurements.push_back(position + QVector3D(rng.gaussian(3), rng.gaussian(3), rng.gaussian(3)));
+        }
+    }
+
+    std::vector<double> elapsedMsecs;
+    std::vector<QVector3D> truth;
+    std::vector<bool> detected;
+    std::vector<QVector3D> measurements;
+};
+
+// slow process noise, so that later measurements still say something about earlier positions
+const KalmanTracker3D::Params SMOOTH_MOTION(1e-3, 1e-3, 1e-5, 1e-5, 9, 9, true, 3000);
+
+std::vector<RtsSmoother::Estimate> smooth(const Recording& recording, int lag, const KalmanTracker3D::Params& p = SMOOTH_MOTION)
+{
+    RtsSmoother smoother(lag, p);
+    std::vector<RtsSmoother::Estimate> result;
+    RtsSmoother::Estimate estimate;
+    for (size_t frame = 0; frame < recording.truth.size(); ++frame) {
+        smoother.step(int(frame), recording.elapsedMsecs[frame], recording.detected[frame] ? &recording.measurements[frame] : nullptr);
+        while (smoother.takeEstimate(estimate)) {
+            result.push_back(estimate);
+        }
+    }
+    smoother.finish();
+    while (smoother.takeEstimate(estimate)) {
+        result.push_back(estimate);
+    }
+    return result;
+}
+
+void verifyClose(double actual, double expected)
+{
+    QVERIFY2(qAbs(actual - expected) <= TOLERANCE * qMax(1.0, qAbs(expected)),
+        qPrintable(QString("%1 != %2").arg(actual, 0, 'g', 17).arg(expected, 0, 'g', 17)));
+}
+}
+
+void TestKalmanFilter::filter_should_match_opencv()
+{
+    const KalmanTracker3D::Params p = KalmanTracker3D::movingTanksParams();
+    cv::KalmanFilter expected = openCvFilter(p);
+    expected.statePost = cv::Mat::zeros(6, 1, CV_64F);
+    cv::setIdentity(expected.errorCovPost);
+
+    KalmanFilter<6, 3> filter;
+    filter.measurement = cv::Matx<double, 3, 6>(expected.measurementMatrix);
+    filter.processNoise = cv::Matx<double, 6, 6>(expected.processNoiseCov);
+    filter.measurementNoise = cv::Matx33d(expected.measurementNoiseCov);
+    filter.reset(cv::Vec<double, 6>::all(0));
+
+    cv::RNG rng(42);
+    for (int frame = 0; frame < 200; ++frame) {
+        const double dt = rng.uniform(10.0, 50.0);
+        for (int i = 0; i < 3; ++i) {
+            expected.transitionMatrix.at<double>(i, i + 3) = filter.transition(i, i + 3) = dt;
+        }
+        expected.predict();
+        filter.predict();
+        if (frame % 5 != 4) {
+            const cv::Vec3d z(rng.gaussian(100) + frame, rng.gaussian(100), rng.gaussian(10) + 1000);
+            expected.correct(cv::Mat(z));
+            filter.correct(z);
+        }
+        for (int i = 0; i < 6; ++i) {
+            verifyClose(filter.state[i], expected.statePost.at<double>(i));
+            for (int j = 0; j < 6; ++j) {
+                verifyClose(filter.errorCov(i, j), expected.errorCovPost.at<double>(i, j));
+            }
+        }
+    }
+}
+
+void TestKalmanFilter::tracker3d_should_match_opencv_data()
+{
+    QTest::addColumn<int>("params");
+    QTest::newRow("moving tanks") << 0;
+    QTest::newRow("static marker") << 1;
+}
+
+void TestKalmanFilter::tracker3d_should_match_opencv()
+{
+    QFETCH(int, params);
+    const KalmanTracker3D::Params& p = params == 0 ? KalmanTracker3D::movingTanksParams() : KalmanTracker3D::staticMarkerParams();
+    KalmanTracker3D tracker(p);
+    cv::KalmanFilter expected = openCvFilter(p);
+    double countDown = 0;
+
+    cv::RNG rng(7);
+    for (int frame = 0; frame < 500; ++frame) {
+        // with regular gaps long enough to time out
+        const double dt = frame % 100 < 90 ? rng.uniform(10.0, 50.0) : 1000.0;
+        tracker.predict(dt);
+        countDown -= dt;
+        if (countDown > 0) {
+            for (int i = 0; i < 3; ++i) {
+                expected.transitionMatrix.at<double>(i, i + 3) = dt;
+            }
+            expected.predict();
+        }
+        if (frame % 100 < 90) {
+            const QVector3D position(rng.gaussian(50) + frame, rng.gaussian(50), rng.gaussian(5) + 1000);
+            tracker.update(position);
+            const cv::Mat z = (cv::Mat_<double>(3, 1) << position.x(), position.y(), position.z());
+            if (countDown <= 0) {
+                expected.statePost = cv::Mat::zeros(6, 1, CV_64F);
+                z.copyTo(expected.statePost.rowRange(0, 3));
+                cv::setIdentity(expected.errorCovPost);
+            } else {
+                expected.correct(z);
+            }
+            countDown = p.notUpdatedTimeoutInMsec;
+        }
+        QCOMPARE(tracker.hasPosition(), countDown > 0);
+        const QVector3D actual = tracker.position();
+        for (int i = 0; i < 3; ++i) {
+            QVERIFY(qAbs(actual[i] - float(expected.statePost.at<double>(i))) <= 1e-3f);
+        }
+    }
+}
+
+void TestKalmanFilter::bank_should_match_trackers()
+{
+    const int trackCount = 20;
+    KalmanFilterBank bank;
+    std::vector<std::unique_ptr<KalmanTracker3D>> trackers;
+    for (int track = 0; track < trackCount; ++track) {
+        QCOMPARE(bank.add(), track);
+        trackers.emplace_back(new KalmanTracker3D(KalmanTracker3D::movingTanksParams()));
+    }
+
+    cv::RNG rng(3);
+    for (int frame = 0; frame < 300; ++frame) {
+        const double dt = rng.uniform(10.0, 400.0);
+        for (int track = 0; track < trackCount; ++track) {
+            trackers[track]->predict(dt);
+            // every track has its own detection rate
+            if (rng.uniform(0, trackCount) >= track) {
+                const QVector3D position(rng.gaussian(50) + frame, rng.gaussian(50) + track, rng.gaussian(5) + 1000);
+                bank.setMeasurement(track, position);
+                trackers[track]->update(position);
+            }
+        }
+        bank.step(dt);
+        for (int track = 0; track < trackCount; ++track) {
+            QCOMPARE(bank.hasPosition(track), trackers[track]->hasPosition());
+            QCOMPARE(bank.position(track), trackers[track]->position());
+        }
+    }
+}
+
+void TestKalmanFilter::bank_should_move_last_track_on_remove()
+{
+    KalmanFilterBank bank;
+    std::vector<std::unique_ptr<KalmanTracker3D>> trackers;
+    cv::RNG rng(13);
+    for (int frame = 0; frame < 300; ++frame) {
+        // tracks come and go, a removed track takes the last one in its place
+        if (frame % 3 == 0) {
+            QCOMPARE(bank.add(), int(trackers.size()));
+            trackers.emplace_back(new KalmanTracker3D(KalmanTracker3D::movingTanksParams()));
+        }
+        if (frame % 5 == 4 && !trackers.empty()) {
+            const int track = rng.uniform(0, int(trackers.size()));
+            bank.remove(track);
+            trackers[track] = std::move(trackers.back());
+            trackers.pop_back();
+        }
+        QCOMPARE(bank.size(), int(trackers.size()));
+
+        const double dt = rng.uniform(10.0, 50.0);
+        for (int track = 0; track < bank.size(); ++track) {
+            trackers[track]->predict(dt);
+            if (rng.uniform(0, 4) != 0) {
+                const QVector3D position(rng.gaussian(50) + frame, rng.gaussian(50) + track, rng.gaussian(5) + 1000);
+                bank.setMeasurement(track, position);
+                trackers[track]->update(position);
+            }
+        }
+        bank.step(dt);
+        for (int track = 0; track < bank.size(); ++track) {
+            QCOMPARE(bank.hasPosition(track), trackers[track]->hasPosition());
+            QCOMPARE(bank.position(track), trackers[track]->position());
+        }
+    }
+}
+
+void TestKalmanFilter::smoother_should_end_on_tracker()
+{
+    const Recording recording(500, 11);
+    KalmanTracker3D tracker(KalmanTracker3D::movingTanksParams());
+    for (size_t frame = 0; frame < recording.truth.size(); ++frame) {
+        tracker.predict(recording.elapsedMsecs[frame]);
+        if (recording.detected[frame]) {
+            tracker.update(recording.measurements[frame]);
+        }
+    }
+    const auto estimates = smooth(recording, 0, KalmanTracker3D::movingTanksParams());
+    QVERIFY(!estimates.empty());
+    // nothing follows the last step, so its smoothed estimate is the filtered one
+    QCOMPARE(estimates.back().frame, int(recording.truth.size()) - 1);
+    QCOMPARE(estimates.back().position, tracker.position());
+}
+
+void TestKalmanFilter::smoother_should_reduce_error()
+{
+    const Recording recording(3000, 5);
+    KalmanTracker3D tracker(SMOOTH_MOTION);
+    double filteredError = 0;
+    double smoothedError = 0;
+    const auto estimates = smooth(recording, 0);
+    auto estimate = estimates.begin();
+    for (size_t frame = 0; frame < recording.truth.size(); ++frame) {
+        tracker.predict(recording.elapsedMsecs[frame]);
+        if (recording.detected[frame]) {
+            tracker.update(recording.measurements[frame]);
+        }
+        QCOMPARE(estimate != estimates.end() && estimate->frame == int(frame), tracker.hasPosition());
+        if (tracker.hasPosition()) {
+            filteredError += (tracker.position() - recording.truth[frame]).lengthSquared();
+            smoothedError += (estimate->position - recording.truth[frame]).lengthSquared();
+            ++estimate;
+        }
+    }
+    QVERIFY2(smoothedError < 0.7 * filteredError, qPrintable(QString("%1 >= 0.7 * %2").arg(smoothedError).arg(filteredError)));
+}
+
+void TestKalmanFilter::fixed_lag_should_match_whole_recording()
+{
+    // spans several blocks of the spill files
+    const Recording recording(10000, 9);
+    const auto whole = smooth(recording, 0);
+    const auto fixedLag = smooth(recording, int(recording.truth.size()));
+    QCOMPARE(fixedLag.size(), whole.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        QCOMPARE(fixedLag[i].frame, whole[i].frame);
+        QCOMPARE(fixedLag[i].position, whole[i].position);
+        QCOMPARE(fixedLag[i].velocity, whole[i].velocity);
+    }
+
+    // a short lag is already most of the way from filtered to smoothed
+    const auto shortLag = smooth(recording, 30);
+    QCOMPARE(shortLag.size(), whole.size());
+    double shortLagError = 0;
+    for (size_t i = 0; i < whole.size(); ++i) {
+        shortLagError += (shortLag[i].position - whole[i].position).length();
+    }
+    QVERIFY(shortLagError / whole.size() < 1.0);
+}
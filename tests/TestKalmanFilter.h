@@ -0,0 +1,32 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <QObject>
+
+class TestKalmanFilter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void filter_should_match_opencv();
+    void tracker3d_should_match_opencv_data();
+    void tracker3d_should_match_opencv();
+    void bank_should_match_trackers();
+    void bank_should_move_last_track_on_remove();
+    void smoother_should_end_on_tracker();
+    void smoother_should_reduce_error();
+    void fixed_lag_should_match_whole_recording();
+};
@@ -0,0 +1,80 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestLoadGovernor.h"
+#include "TestFactory.h"
+#include "Track3d/LoadGovernor.h"
+
+REGISTER_TESTCLASS(TestLoadGovernor);
+
+namespace {
+const float BUDGET = 30.0f;
+const int HOLD_FRAMES = 30;
+
+// returns how often the level changed
+int addFrames(LoadGovernor& governor, float msecs, int count)
+{
+    int changes = 0;
+    for (int i = 0; i < count; ++i) {
+        if (governor.addFrameTime(msecs, true)) {
+            changes++;
+        }
+    }
+    return changes;
+}
+}
+
+void TestLoadGovernor::governor_should_step_up_while_over_budget()
+{
+    LoadGovernor governor(4, 0.6f, HOLD_FRAMES);
+    governor.setBudget(BUDGET);
+
+    QCOMPARE(addFrames(governor, 2 * BUDGET, HOLD_FRAMES), 1);
+    QCOMPARE(governor.level(), 1);
+    QCOMPARE(governor.detectionScale(), 0.5);
+    QCOMPARE(governor.detectionInterval(), 1);
+
+    QCOMPARE(addFrames(governor, 2 * BUDGET, 10 * HOLD_FRAMES), 3);
+    QCOMPARE(governor.level(), 4);
+    QCOMPARE(governor.detectionInterval(), 4);
+}
+
+void TestLoadGovernor::governor_should_stay_reduced_while_full_resolution_is_over_budget()
+{
+    LoadGovernor governor(4, 0.6f, HOLD_FRAMES);
+    governor.setBudget(BUDGET);
+    addFrames(governor, 2 * BUDGET, HOLD_FRAMES);
+    QCOMPARE(governor.level(), 1);
+
+    // half resolution fits easily, but the same frames at full resolution would not
+    QCOMPARE(addFrames(governor, BUDGET / 2, 10 * HOLD_FRAMES), 0);
+    QCOMPARE(governor.level(), 1);
+}
+
+void TestLoadGovernor::governor_should_step_down_when_full_resolution_fits()
+{
+    LoadGovernor governor(4, 0.6f, HOLD_FRAMES);
+    governor.setBudget(BUDGET);
+    addFrames(governor, 2 * BUDGET, HOLD_FRAMES);
+    QCOMPARE(governor.level(), 1);
+
+    QCOMPARE(addFrames(governor, BUDGET / 10, 2 * HOLD_FRAMES), 1);
+    QCOMPARE(governor.level(), 0);
+    QCOMPARE(governor.detectionScale(), 1.0);
+
+    QCOMPARE(addFrames(governor, BUDGET / 10, 10 * HOLD_FRAMES), 0);
+    QCOMPARE(governor.level(), 0);
+}
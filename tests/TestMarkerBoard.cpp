@@ -0,0 +1,150 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestMarkerBoard.h"
+#include "Aruco/Aruco.h"
+#include "Aruco/MarkerBoard.h"
+#include "TestFactory.h"
+#include <QFile>
+#include <QTemporaryDir>
+#include <opencv2/calib3d.hpp>
+
+REGISTER_TESTCLASS(TestMarkerBoard);
+
+namespace {
+const float MARKER_LENGTH = 32.0f;
+
+cv::Mat cameraMatrix()
+{
+    return (cv::Mat_<double>(3, 3) << 800, 0, 320, 0, 800, 240, 0, 0, 1);
+}
+
+cv::Mat distCoeffs()
+{
+    return cv::Mat::zeros(1, 5, CV_64F);
+}
+
+MarkerBoard threeMarkerBoard()
+{
+    MarkerBoard board(10);
+    board.addMarker(10, cv::Point3f(0, 0, 0), MARKER_LENGTH);
+    board.addMarker(11, cv::Point3f(60, 0, 0), MARKER_LENGTH);
+    board.addMarker(12, cv::Point3f(0, 60, 0), MARKER_LENGTH);
+    return board;
+}
+
+// appends the projected corners of a marker with the given model corners
+void addMarker(Aruco::Markers& markers, int id, const cv::Point3f* modelCorners, const cv::Vec3d& rvec, const cv::Vec3d& tvec)
+{
+    std::vector<cv::Point3f> model(modelCorners, modelCorners + 4);
+    std::vector<cv::Point2f> image;
+    cv::projectPoints(model, rvec, tvec, cameraMatrix(), distCoeffs(), image);
+    std::copy(image.cbegin(), image.cend(), markers.corners + 4 * markers.count);
+    markers.ids[markers.count++] = id;
+}
+}
+
+void TestMarkerBoard::load_should_validate_board_ids()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, expectedOk);
+    QFETCH(int, expectedCount);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("boards.json"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(json);
+    file.close();
+
+    bool ok = !expectedOk;
+    const std::vector<MarkerBoard> boards = MarkerBoard::load(file.fileName(), &ok);
+    QCOMPARE(ok, expectedOk);
+    QCOMPARE(int(boards.size()), expectedCount);
+}
+
+void TestMarkerBoard::load_should_validate_board_ids_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("expectedOk");
+    QTest::addColumn<int>("expectedCount");
+
+    QTest::newRow("valid") << QByteArray(R"({ "boards": [
+        { "id": 10, "markers": [ { "id": 10, "x": 0, "y": 0, "z": 0, "length": 32 },
+                                 { "id": 11, "x": 60, "y": 0, "z": 0, "length": 32 } ] },
+        { "id": 20, "markers": [ { "id": 20, "x": 0, "y": 0, "z": 0, "length": 32 } ] } ] })")
+                           << true << 2;
+    QTest::newRow("missing id") << QByteArray(R"({ "boards": [
+        { "markers": [ { "id": 0, "x": 0, "y": 0, "z": 0, "length": 32 } ] } ] })")
+                                << false << 0;
+    QTest::newRow("id of a marker not on the board") << QByteArray(R"({ "boards": [
+        { "id": 5, "markers": [ { "id": 10, "x": 0, "y": 0, "z": 0, "length": 32 } ] } ] })")
+                                                     << false << 0;
+    QTest::newRow("duplicate id") << QByteArray(R"({ "boards": [
+        { "id": 10, "markers": [ { "id": 10, "x": 0, "y": 0, "z": 0, "length": 32 } ] },
+        { "id": 10, "markers": [ { "id": 10, "x": 0, "y": 0, "z": 0, "length": 32 },
+                                 { "id": 11, "x": 60, "y": 0, "z": 0, "length": 32 } ] } ] })")
+                                  << false << 0;
+}
+
+void TestMarkerBoard::estimateBoardPose_should_recover_projected_pose()
+{
+    Aruco aruco;
+    aruco.setCameraMatrix(cameraMatrix(), distCoeffs());
+    const MarkerBoard board = threeMarkerBoard();
+    const cv::Vec3d expectedRvec(0.2, -0.1, 0.05);
+    const cv::Vec3d expectedTvec(10, -20, 500);
+
+    Aruco::Markers markers;
+    for (int i = 0; i < board.markerCount(); ++i) {
+        addMarker(markers, 10 + i, board.corners(i), expectedRvec, expectedTvec);
+    }
+    // a marker that is not on the board must not take part
+    MarkerBoard other;
+    other.addMarker(30, cv::Point3f(200, 0, 0), MARKER_LENGTH);
+    addMarker(markers, 30, other.corners(0), cv::Vec3d(0, 0.5, 0), expectedTvec);
+
+    cv::Vec3d rvec, tvec;
+    QCOMPARE(aruco.estimateBoardPose(board, markers, rvec, tvec), 3);
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(qAbs(rvec[i] - expectedRvec[i]) < 1e-3);
+        QVERIFY(qAbs(tvec[i] - expectedTvec[i]) < 1e-1);
+    }
+}
+
+void TestMarkerBoard::estimatePoses_should_leave_board_markers_to_the_board()
+{
+    Aruco aruco;
+    aruco.setCameraMatrix(cameraMatrix(), distCoeffs());
+    const std::vector<MarkerBoard> boards { threeMarkerBoard() };
+    const cv::Vec3d rvec(0.2, -0.1, 0.05);
+    const cv::Vec3d tvec(10, -20, 500);
+
+    Aruco::Markers markers;
+    addMarker(markers, 10, boards.front().corners(0), rvec, tvec);
+    MarkerBoard single;
+    single.addMarker(30, cv::Point3f(0, 0, 0), MARKER_LENGTH);
+    addMarker(markers, 30, single.corners(0), rvec, tvec);
+    const cv::Point2f boardCorner = markers.corners[0];
+
+    aruco.estimatePoses(markers, &boards);
+    QCOMPARE(markers.count, 2);
+    QCOMPARE(markers.ids[0], 10);
+    QVERIFY(markers.corners[0] == boardCorner);
+    QVERIFY(markers.tvecs[0] == cv::Vec3d());
+    QCOMPARE(markers.ids[1], 30);
+    QVERIFY(qAbs(markers.tvecs[1][2] - tvec[2]) < 1.0);
+}
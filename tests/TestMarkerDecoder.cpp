@@ -0,0 +1,85 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestMarkerDecoder.h"
+#include "Aruco/MarkerDecoder.h"
+#include "TestFactory.h"
+
+REGISTER_TESTCLASS(TestMarkerDecoder);
+
+namespace {
+cv::Mat markerBits(const cv::Ptr<cv::aruco::Dictionary>& dictionary, int id, int rotation)
+{
+    cv::Mat bits = cv::aruco::Dictionary::getBitsFromByteList(dictionary->bytesList.rowRange(id, id + 1), 4);
+    for (int i = 0; i < rotation; ++i) {
+        cv::rotate(bits, bits, cv::ROTATE_90_CLOCKWISE);
+    }
+    return bits;
+}
+}
+
+void TestMarkerDecoder::identify_should_find_every_rotated_marker()
+{
+    auto dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_50);
+    MarkerDecoder<4> decoder(dictionary);
+    for (int id = 0; id < dictionary->bytesList.rows; ++id) {
+        for (int rotation = 0; rotation < 4; ++rotation) {
+            int foundId = -1;
+            int foundRotation = -1;
+            QVERIFY(decoder.identify(markerBits(dictionary, id, rotation), foundId, foundRotation));
+            QCOMPARE(foundId, id);
+            QCOMPARE(foundRotation, rotation);
+        }
+    }
+}
+
+void TestMarkerDecoder::identify_should_correct_one_bit()
+{
+    auto dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_50);
+    MarkerDecoder<4> decoder(dictionary, 1);
+    for (int id = 0; id < dictionary->bytesList.rows; ++id) {
+        for (int i = 0; i < 16; ++i) {
+            cv::Mat bits = markerBits(dictionary, id, 1);
+            bits.at<uchar>(i / 4, i % 4) ^= 1;
+            int foundId = -1;
+            int foundRotation = -1;
+            QVERIFY(decoder.identify(bits, foundId, foundRotation));
+            QCOMPARE(foundId, id);
+            QCOMPARE(foundRotation, 1);
+        }
+    }
+}
+
+void TestMarkerDecoder::identify_should_reject_noise()
+{
+    // whatever the table accepts must also be accepted by opencv with the same correction
+    auto dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_50);
+    MarkerDecoder<4> decoder(dictionary, 0);
+    for (int code = 0; code < (1 << 16); code += 7) {
+        int foundId = -1;
+        int foundRotation = -1;
+        if (decoder.identify(uint16_t(code), foundId, foundRotation)) {
+            cv::Mat bits(4, 4, CV_8UC1);
+            for (int i = 0; i < 16; ++i) {
+                bits.at<uchar>(i / 4, i % 4) = (code >> (15 - i)) & 1;
+            }
+            int expectedId = -1;
+            int expectedRotation = -1;
+            QVERIFY(dictionary->identify(bits, expectedId, expectedRotation, 0.0));
+            QCOMPARE(foundId, expectedId);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestMarkerTable.h"
+#include "Kalman/KalmanFilterBank.h"
+#include "TestFactory.h"
+#include "Track3d/MarkerTable.h"
+#include <algorithm>
+
+REGISTER_TESTCLASS(TestMarkerTable);
+
+namespace {
+QVector3D positionOf(int id)
+{
+    return QVector3D(100.0f * id, -10.0f * id, 1000.0f);
+}
+
+// measures every marker at its own position and steps the filters once
+void measureAll(MarkerTable& table, KalmanFilterBank& filters)
+{
+    for (int i = 0; i < table.size(); ++i) {
+        table.at(i).setPositionRotation(positionOf(table.at(i).id()), QQuaternion());
+    }
+    filters.step(33.0);
+}
+
+QList<int> missingIds(MarkerTable& table)
+{
+    QList<int> result;
+    table.forEachMissing([&result](Marker& marker) { result << marker.id(); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void verifyTable(MarkerTable& table, KalmanFilterBank& filters)
+{
+    QCOMPARE(filters.size(), table.size());
+    for (int i = 0; i < table.size(); ++i) {
+        Marker& marker = table.at(i);
+        QCOMPARE(marker.track(), i);
+        QCOMPARE(table.find(marker.id()), &marker);
+        if (filters.hasPosition(i)) {
+            QVERIFY(marker.filteredPos().distanceToPoint(positionOf(marker.id())) < 1e-3f);
+        }
+    }
+}
+}
+
+void TestMarkerTable::remove_should_move_last_marker_and_track()
+{
+    KalmanFilterBank filters;
+    MarkerTable table(&filters);
+    // 70 lies in the second word of the id bitsets
+    for (int id : { 3, 70, 5, 9 }) {
+        QVERIFY(table.markerFor(id));
+    }
+    measureAll(table, filters);
+    verifyTable(table, filters);
+
+    table.remove(70);
+    QCOMPARE(table.size(), 3);
+    QVERIFY(!table.find(70));
+    QCOMPARE(table.at(1).id(), 9);
+    verifyTable(table, filters);
+
+    table.clearFound();
+    table.setFound(3);
+    QCOMPARE(missingIds(table), QList<int>({ 5, 9 }));
+
+    // the last marker and an unknown id leave the others in place
+    table.remove(5);
+    table.remove(42);
+    QCOMPARE(table.size(), 2);
+    QVERIFY(!table.find(5));
+    verifyTable(table, filters);
+    QCOMPARE(missingIds(table), QList<int>({ 9 }));
+}
+
+void TestMarkerTable::removed_id_should_start_over()
+{
+    KalmanFilterBank filters;
+    MarkerTable table(&filters);
+    for (int id : { 3, 70, 5 }) {
+        table.markerFor(id);
+    }
+    measureAll(table, filters);
+    table.remove(70);
+
+    Marker* marker = table.markerFor(70);
+    QVERIFY(marker);
+    QCOMPARE(table.size(), 3);
+    QCOMPARE(marker->track(), 2);
+    QVERIFY(!filters.hasPosition(marker->track()));
+    QVERIFY(!marker->isDetectedFiltered());
+    verifyTable(table, filters);
+
+    table.clearFound();
+    QCOMPARE(missingIds(table), QList<int>({ 3, 5, 70 }));
+
+    measureAll(table, filters);
+    verifyTable(table, filters);
+    QVERIFY(filters.hasPosition(marker->track()));
+}
@@ -0,0 +1,66 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestOrientationFilter.h"
+#include "Kalman/OrientationFilter.h"
+#include "TestFactory.h"
+
+REGISTER_TESTCLASS(TestOrientationFilter);
+
+void TestOrientationFilter::rotationVector_should_round_trip()
+{
+    QFETCH(QVector3D, rotation);
+    const QVector3D result = OrientationFilter::toRotationVector(OrientationFilter::fromRotationVector(rotation));
+    QVERIFY((result - rotation).length() < 1e-5f);
+}
+
+void TestOrientationFilter::rotationVector_should_round_trip_data()
+{
+    QTest::addColumn<QVector3D>("rotation");
+    QTest::newRow("identity") << QVector3D(0, 0, 0);
+    QTest::newRow("tiny") << QVector3D(1e-7f, -2e-7f, 0);
+    QTest::newRow("about z") << QVector3D(0, 0, 1.5f);
+    QTest::newRow("oblique") << QVector3D(0.3f, -0.8f, 0.5f);
+    QTest::newRow("almost half turn") << QVector3D(0, 3.1f, 0);
+}
+
+void TestOrientationFilter::filter_should_follow_constant_rotation()
+{
+    OrientationFilter filter(OrientationFilter::movingTanksParams());
+    const QQuaternion start = OrientationFilter::fromRotationVector(QVector3D(0.2f, -0.1f, 0.4f));
+    const QVector3D angularVelocity(0, 0, 0.002f); // body frame, about 115 degrees per second
+    const double dt = 33;
+
+    QQuaternion actual = start;
+    for (int frame = 0; frame < 150; ++frame) {
+        actual = actual * OrientationFilter::fromRotationVector(angularVelocity * dt);
+        filter.predict(dt);
+        filter.update(actual);
+        QVERIFY(filter.hasOrientation());
+    }
+
+    QVERIFY((filter.angularVelocity() - angularVelocity).length() < 1e-4f);
+    QQuaternion error = filter.orientation().conjugated() * actual;
+    QVERIFY(OrientationFilter::toRotationVector(error.scalar() < 0 ? -error : error).length() < 0.01f);
+
+    // keeps turning without measurements
+    for (int frame = 0; frame < 10; ++frame) {
+        actual = actual * OrientationFilter::fromRotationVector(angularVelocity * dt);
+        filter.predict(dt);
+    }
+    error = filter.orientation().conjugated() * actual;
+    QVERIFY(OrientationFilter::toRotationVector(error.scalar() < 0 ? -error : error).length() < 0.02f);
+}
@@ -20,6 +20,32 @@
 
 REGISTER_TESTCLASS(TestPlane3d);
 
+namespace {
+// for the PlaneFitter tests, same checks as fit_plane_should_give_expected_results
+void verifyPlane(const Plane3d& plane, double a, double b, double c, double d)
+{
+    if (qFuzzyIsNull(a))
+        QVERIFY(qFuzzyIsNull(plane.a()));
+    else
+        QCOMPARE(plane.a(), a);
+
+    if (qFuzzyIsNull(b))
+        QVERIFY(qFuzzyIsNull(plane.b()));
+    else
+        QCOMPARE(plane.b(), b);
+
+    if (qFuzzyIsNull(c))
+        QVERIFY(qFuzzyIsNull(plane.c()));
+    else
+        QCOMPARE(plane.c(), c);
+
+    if (qFuzzyIsNull(d))
+        QVERIFY(qFuzzyIsNull(plane.d()));
+    else
+        QCOMPARE(plane.d(), d);
+}
+}
+
 void TestPlane3d::constructor_should_initialize_properties()
 {
     Plane3d plane(1, 2, 3, 4);
@@ -104,3 +130,75 @@ void TestPlane3d::fit_plane_should_give_expected_results_data()
         << true
         << 0.423076923077 << 0.615384615385 << 0.538461538462 << -0.576923076923;
 }
+
+void TestPlane3d::fitter_should_give_expected_results()
+{
+    QFETCH(QList<QVector3D>, points);
+    QFETCH(bool, ok);
+    QFETCH(double, a);
+    QFETCH(double, b);
+    QFETCH(double, c);
+    QFETCH(double, d);
+
+    PlaneFitter fitter;
+    for (const auto& point : points) {
+        fitter.add(point);
+    }
+    QCOMPARE(fitter.count(), points.size());
+
+    bool resultOk = false;
+    Plane3d plane = fitter.fit(&resultOk);
+
+    QCOMPARE(resultOk, ok);
+    verifyPlane(plane, a, b, c, d);
+}
+
+void TestPlane3d::fitter_should_give_expected_results_data()
+{
+    fit_plane_should_give_expected_results_data();
+
+    QTest::newRow("points on a line")
+        << (QList<QVector3D>() << QVector3D(0, 0, 0) << QVector3D(1, 1, 1) << QVector3D(2, 2, 2) << QVector3D(3, 3, 3))
+        << false
+        << 0.0 << 0.0 << 0.0 << 0.0;
+}
+
+void TestPlane3d::fitter_should_forget_removed_points()
+{
+    // markers around 2 m from the camera on the plane z = 2000 - 0.5 x, and some off it
+    QList<QVector3D> onPlane;
+    QList<QVector3D> offPlane;
+    for (int i = 0; i < 20; ++i) {
+        const float x = -500 + 50 * i;
+        const float y = 300 * float(i % 4) - 450;
+        onPlane << QVector3D(x, y, 2000 - 0.5f * x);
+        offPlane << QVector3D(y, x, 2500 + 10 * i);
+    }
+
+    PlaneFitter fitter;
+    for (int i = 0; i < onPlane.size(); ++i) {
+        fitter.add(offPlane.at(i));
+        fitter.add(onPlane.at(i));
+    }
+    // markers moving around for a while before the off plane ones leave
+    for (int frame = 0; frame < 1000; ++frame) {
+        const int i = frame % offPlane.size();
+        fitter.remove(offPlane.at(i));
+        offPlane[i] += QVector3D(1, -1, 0.5f);
+        fitter.add(offPlane.at(i));
+    }
+    for (const auto& point : offPlane) {
+        fitter.remove(point);
+    }
+    QCOMPARE(fitter.count(), onPlane.size());
+
+    bool ok = false;
+    const Plane3d plane = fitter.fit(&ok);
+    QVERIFY(ok);
+    // 0.5 x + z - 2000 = 0, scaled to a + b + c + d = 1
+    const double scale = 0.5 + 1 - 2000;
+    QVERIFY(qAbs(plane.a() - 0.5 / scale) < 1e-9);
+    QVERIFY(qAbs(plane.b()) < 1e-9);
+    QVERIFY(qAbs(plane.c() - 1 / scale) < 1e-9);
+    QVERIFY(qAbs(plane.d() + 2000 / scale) < 1e-6);
+}
@@ -25,4 +25,8 @@ private slots:
 
     void fit_plane_should_give_expected_results();
     void fit_plane_should_give_expected_results_data();
+
+    void fitter_should_give_expected_results();
+    void fitter_should_give_expected_results_data();
+    void fitter_should_forget_removed_points();
 };
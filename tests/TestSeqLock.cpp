@@ -0,0 +1,83 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestSeqLock.h"
+#include "TestFactory.h"
+#include "Track3d/SeqLock.h"
+#include <atomic>
+#include <thread>
+
+REGISTER_TESTCLASS(TestSeqLock);
+
+namespace {
+const int STORE_COUNT = 100000;
+
+// spans several words, all derived from n so a mix of two stores shows
+struct Pose {
+    double x;
+    double y;
+    double z;
+    qint64 n;
+};
+
+Pose poseFor(qint64 n)
+{
+    return { double(n), 2.0 * n, -double(n), n };
+}
+
+bool isConsistent(const Pose& pose)
+{
+    return pose.y == 2 * pose.x && pose.z == -pose.x && pose.n == qint64(pose.x);
+}
+}
+
+void TestSeqLock::load_should_return_stored_value()
+{
+    SeqLock<Pose> lock;
+    QCOMPARE(lock.load().n, qint64(0));
+
+    lock.store(poseFor(7));
+    const Pose pose = lock.load();
+    QVERIFY(isConsistent(pose));
+    QCOMPARE(pose.n, qint64(7));
+}
+
+void TestSeqLock::reader_should_never_see_a_torn_value()
+{
+    SeqLock<Pose> lock;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (qint64 n = 1; n <= STORE_COUNT; ++n) {
+            lock.store(poseFor(n));
+        }
+        done = true;
+    });
+
+    qint64 last = 0;
+    bool torn = false;
+    bool older = false;
+    while (!done) {
+        const Pose pose = lock.load();
+        torn = torn || !isConsistent(pose);
+        older = older || pose.n < last;
+        last = pose.n;
+    }
+    writer.join();
+
+    QVERIFY(!torn);
+    QVERIFY(!older);
+    QCOMPARE(lock.load().n, qint64(STORE_COUNT));
+}
@@ -0,0 +1,93 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestSquarePose.h"
+#include "Aruco/SquarePose.h"
+#include "TestFactory.h"
+#include <opencv2/calib3d.hpp>
+
+REGISTER_TESTCLASS(TestSquarePose);
+
+Q_DECLARE_METATYPE(cv::Vec3d)
+
+namespace {
+const double MARKER_LENGTH = 32.0;
+}
+
+void TestSquarePose::solve_should_recover_projected_pose()
+{
+    QFETCH(cv::Vec3d, rvec);
+    QFETCH(cv::Vec3d, tvec);
+
+    cv::Matx33d expectedRotation;
+    cv::Rodrigues(rvec, expectedRotation);
+
+    const double l2 = MARKER_LENGTH / 2;
+    const cv::Vec3d model[4] = { { -l2, l2, 0 }, { l2, l2, 0 }, { l2, -l2, 0 }, { -l2, -l2, 0 } };
+    cv::Point2f corners[4];
+    for (int i = 0; i < 4; ++i) {
+        cv::Vec3d p = expectedRotation * model[i] + tvec;
+        corners[i] = cv::Point2f(p[0] / p[2], p[1] / p[2]);
+    }
+
+    cv::Matx33d rotation;
+    cv::Vec3d translation;
+    QVERIFY(SquarePose::solve(corners, MARKER_LENGTH, rotation, translation));
+
+    for (int i = 0; i < 9; ++i) {
+        QVERIFY(qAbs(rotation.val[i] - expectedRotation.val[i]) < 1e-3);
+    }
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(qAbs(translation[i] - tvec[i]) < 1e-2);
+    }
+}
+
+void TestSquarePose::solve_should_recover_projected_pose_data()
+{
+    QTest::addColumn<cv::Vec3d>("rvec");
+    QTest::addColumn<cv::Vec3d>("tvec");
+
+    QTest::newRow("facing camera") << cv::Vec3d(M_PI, 0, 0) << cv::Vec3d(0, 0, 500);
+    QTest::newRow("off center") << cv::Vec3d(M_PI, 0, 0) << cv::Vec3d(-120, 80, 450);
+    QTest::newRow("tilted") << cv::Vec3d(2.8, 0.3, -0.2) << cv::Vec3d(40, -30, 600);
+    QTest::newRow("rotated in plane") << cv::Vec3d(2.2, 2.2, 0.1) << cv::Vec3d(10, 20, 400);
+}
+
+void TestSquarePose::rotationVector_should_match_rodrigues()
+{
+    QFETCH(cv::Vec3d, rvec);
+
+    cv::Matx33d rotation;
+    cv::Rodrigues(rvec, rotation);
+    cv::Vec3d result = SquarePose::rotationVector(rotation);
+
+    cv::Matx33d resultRotation;
+    cv::Rodrigues(result, resultRotation);
+    for (int i = 0; i < 9; ++i) {
+        QVERIFY(qAbs(resultRotation.val[i] - rotation.val[i]) < 1e-9);
+    }
+}
+
+void TestSquarePose::rotationVector_should_match_rodrigues_data()
+{
+    QTest::addColumn<cv::Vec3d>("rvec");
+
+    QTest::newRow("identity") << cv::Vec3d(0, 0, 0);
+    QTest::newRow("small") << cv::Vec3d(1e-4, -2e-4, 3e-4);
+    QTest::newRow("generic") << cv::Vec3d(0.5, -1.2, 2.0);
+    QTest::newRow("half turn") << cv::Vec3d(M_PI, 0, 0);
+    QTest::newRow("half turn skew") << cv::Vec3d(0, M_PI / sqrt(2), -M_PI / sqrt(2));
+}
@@ -0,0 +1,82 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TestTripleBuffer.h"
+#include "TestFactory.h"
+#include "Track3d/TripleBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+REGISTER_TESTCLASS(TestTripleBuffer);
+
+namespace {
+const int PUBLISH_COUNT = 100000;
+
+// every word holds the same number, a buffer caught while it is written has two different ones
+struct Value {
+    int words[64] = {};
+};
+}
+
+void TestTripleBuffer::read_should_return_last_published_value()
+{
+    TripleBuffer<int> buffer;
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    buffer.publish();
+    QCOMPARE(buffer.read(), 2);
+
+    // not published yet
+    buffer.writeBuffer() = 3;
+    QCOMPARE(buffer.read(), 2);
+
+    buffer.publish();
+    QCOMPARE(buffer.read(), 3);
+    QCOMPARE(buffer.read(), 3);
+}
+
+void TestTripleBuffer::reader_should_never_see_a_buffer_being_written()
+{
+    TripleBuffer<Value> buffer;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int n = 1; n <= PUBLISH_COUNT; ++n) {
+            Value& value = buffer.writeBuffer();
+            for (int& word : value.words) {
+                word = n;
+            }
+            buffer.publish();
+        }
+        done = true;
+    });
+
+    int last = 0;
+    bool torn = false;
+    bool older = false;
+    while (!done) {
+        const Value& value = buffer.read();
+        torn = torn || std::any_of(value.words, value.words + 64, [&value](int word) { return word != value.words[0]; });
+        older = older || value.words[0] < last;
+        last = value.words[0];
+    }
+    writer.join();
+
+    QVERIFY(!torn);
+    QVERIFY(!older);
+    QCOMPARE(buffer.read().words[0], PUBLISH_COUNT);
+}
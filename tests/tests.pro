@@ -22,20 +22,44 @@ include(../link_lib.pri)
 include(../link_opencv.pri)
 
 HEADERS += \
+    TestAruco.h \
+    TestBoundedQueue.h \
+    TestDetectionStats.h \
     TestFactory.h \
     #TestGeneraticAlgorithm.h \
+    TestKalmanFilter.h \
     #TestKalmanTracker1D.h \
+    TestLoadGovernor.h \
+    TestMarkerBoard.h \
+    TestMarkerDecoder.h \
+    TestMarkerTable.h \
+    TestOrientationFilter.h \
     TestPlane3d.h \
     TestRotationCounter.h \
-    TestSourceCode.h
+    TestSeqLock.h \
+    TestSquarePose.h \
+    TestSourceCode.h \
+    TestTripleBuffer.h
 
 SOURCES += \
+    TestAruco.cpp \
+    TestBoundedQueue.cpp \
+    TestDetectionStats.cpp \
     TestFactory.cpp \
     #TestGeneraticAlgorithm.cpp \
+    TestKalmanFilter.cpp \
     #TestKalmanTracker1D.cpp \
+    TestLoadGovernor.cpp \
+    TestMarkerBoard.cpp \
+    TestMarkerDecoder.cpp \
+    TestMarkerTable.cpp \
+    TestOrientationFilter.cpp \
     TestPlane3d.cpp \
     TestRotationCounter.cpp \
+    TestSeqLock.cpp \
+    TestSquarePose.cpp \
     TestSourceCode.cpp \
+    TestTripleBuffer.cpp \
     main.cpp
 
 RESOURCES += resources.qrc
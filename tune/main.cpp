@@ -0,0 +1,198 @@
+/*  ArucoMarkerTracker
+    Copyright (C) 2021 Kuppens Brecht
+    
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Aruco/Aruco.h"
+#include "Calibration/CameraCalibration.h"
+#include "Video/Frame.h"
+#include "Video/Video.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+// Sweeps the aruco detector parameters over a recorded video, measures recall against a reference
+// run and time per frame, and writes the pareto front as parameter files loadable by Aruco.
+//
+// usage: tune <recording folder> <camera calibration file> [output folder] [reference detector params file]
+
+namespace {
+const int MAX_FRAMES = 200;
+
+struct TuningResult {
+    Aruco::DetectorParams params;
+    double recall;
+    double msecsPerFrame;
+    int falseIds;
+    bool pareto;
+};
+
+QVector<QSet<int>> detectIds(const Aruco& aruco, const QVector<QImage>& images, double* msecsPerFrame)
+{
+    QVector<QSet<int>> result;
+    result.reserve(images.size());
+
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for (const QImage& image : images) {
+        timer.start();
+        auto markers = aruco.detectMarkers(image);
+        nsecs += timer.nsecsElapsed();
+
+        QSet<int> ids;
+        for (int i = 0; i < markers.count; ++i) {
+            ids.insert(markers.ids[i]);
+        }
+        result << ids;
+    }
+    if (msecsPerFrame) {
+        *msecsPerFrame = images.isEmpty() ? 0.0 : nsecs / 1e6 / images.size();
+    }
+    return result;
+}
+
+QVector<Aruco::DetectorParams> parameterGrid()
+{
+    QVector<Aruco::DetectorParams> result;
+    for (int winSizeMin : { 3, 5, 7 }) {
+        for (int winSizeMax : { 13, 23, 33 }) {
+            for (int winSizeStep : { 4, 10, 20 }) {
+                for (double polygonalApprox : { 0.03, 0.05, 0.08 }) {
+                    for (double minPerimeterRate : { 0.01, 0.03, 0.05 }) {
+                        Aruco::DetectorParams p;
+                        p.adaptiveThreshWinSizeMin = winSizeMin;
+                        p.adaptiveThreshWinSizeMax = winSizeMax;
+                        p.adaptiveThreshWinSizeStep = winSizeStep;
+                        p.polygonalApproxAccuracyRate = polygonalApprox;
+                        p.minMarkerPerimeterRate = minPerimeterRate;
+                        result << p;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void markParetoFront(QVector<TuningResult>& results)
+{
+    std::sort(results.begin(), results.end(), [](const TuningResult& a, const TuningResult& b) {
+        return a.msecsPerFrame < b.msecsPerFrame || (a.msecsPerFrame == b.msecsPerFrame && a.recall > b.recall);
+    });
+    double bestRecall = -1.0;
+    for (auto& r : results) {
+        r.pareto = r.recall > bestRecall;
+        if (r.pareto) {
+            bestRecall = r.recall;
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() < 3) {
+        qCritical() << "usage: tune <recording folder> <camera calibration file> [output folder] [reference detector params file]";
+        return 1;
+    }
+    const QDir outputDir(args.size() > 3 ? args.at(3) : QDir::currentPath());
+    outputDir.mkpath(QStringLiteral("."));
+
+    Video video;
+    video.load(args.at(1));
+    const int frameCount = video.frames().size();
+    const int step = qMax(1, frameCount / MAX_FRAMES);
+    QVector<QImage> images;
+    for (int i = 0; i < frameCount; i += step) {
+        images << video.frames().at(i)->image();
+    }
+    if (images.isEmpty()) {
+        qCritical() << "No frames found in" << args.at(1);
+        return 1;
+    }
+
+    CameraCalibration calibration;
+    calibration.load(args.at(2));
+    Aruco aruco;
+    aruco.setCameraMatrix(calibration.cameraMatrix(), calibration.distCoeffs(), calibration.imageSize());
+
+    // reference run: an exhaustive threshold sweep finds (nearly) every marker, however slow
+    if (args.size() <= 4 || !aruco.loadDetectorParams(args.at(4))) {
+        aruco.setDetectorParams(Aruco::DetectorParams(3, 53, 2, 7, 0.01, 4.0, 0.05, 5));
+    }
+    double referenceMsecs = 0.0;
+    const QVector<QSet<int>> referenceIds = detectIds(aruco, images, &referenceMsecs);
+    int referenceCount = 0;
+    for (const auto& ids : referenceIds) {
+        referenceCount += ids.size();
+    }
+    qInfo() << "Reference:" << referenceCount << "markers in" << images.size() << "frames," << referenceMsecs << "msec/frame";
+    if (referenceCount == 0) {
+        qCritical() << "Reference run found no markers";
+        return 1;
+    }
+
+    QVector<TuningResult> results;
+    for (const auto& p : parameterGrid()) {
+        if (p.adaptiveThreshWinSizeMax < p.adaptiveThreshWinSizeMin)
+            continue;
+
+        aruco.setDetectorParams(p);
+        TuningResult r;
+        r.params = p;
+        r.falseIds = 0;
+        r.pareto = false;
+        const QVector<QSet<int>> ids = detectIds(aruco, images, &r.msecsPerFrame);
+
+        int found = 0;
+        for (int i = 0; i < ids.size(); ++i) {
+            const int matched = (ids.at(i) & referenceIds.at(i)).size();
+            found += matched;
+            r.falseIds += ids.at(i).size() - matched;
+        }
+        r.recall = double(found) / referenceCount;
+        results << r;
+    }
+    markParetoFront(results);
+
+    QFile file(outputDir.absoluteFilePath(QStringLiteral("tuning.csv")));
+    if (file.open(QIODevice::WriteOnly)) {
+        QTextStream stream(&file);
+        stream << "winSizeMin,winSizeMax,winSizeStep,polygonalApprox,minPerimeterRate,recall,msecPerFrame,falseIds,pareto\n";
+        for (const auto& r : results) {
+            stream << r.params.adaptiveThreshWinSizeMin << "," << r.params.adaptiveThreshWinSizeMax << "," << r.params.adaptiveThreshWinSizeStep
+                   << "," << r.params.polygonalApproxAccuracyRate << "," << r.params.minMarkerPerimeterRate
+                   << "," << r.recall << "," << r.msecsPerFrame << "," << r.falseIds << "," << (r.pareto ? 1 : 0) << "\n";
+        }
+    }
+
+    int paretoIndex = 0;
+    for (const auto& r : results) {
+        if (r.pareto) {
+            QString filename = outputDir.absoluteFilePath(QStringLiteral("pareto%1.json").arg(paretoIndex++, 2, 10, QChar('0')));
+            aruco.setDetectorParams(r.params);
+            aruco.saveDetectorParams(filename);
+            qInfo() << "Pareto:" << filename << "recall" << r.recall << "," << r.msecsPerFrame << "msec/frame," << r.falseIds << "false ids";
+        }
+    }
+    return 0;
+}